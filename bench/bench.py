@@ -0,0 +1,98 @@
+"""The tester's own overhead (see README.org, "make bench").
+
+    bench.py summarize bench-raw.csv > bench.csv
+    bench.py compare reference.csv bench.csv [tolerance]
+
+summarize reduces the tester's CSV to per-case, per-operation times.
+compare checks them against a reference made on the same machine, e.g.,
+with the base branch or another HDF5 release. A metric regresses when the
+geometric mean of its ratios over all cases exceeds 1 + tolerance (default
+0.10). Single cases are too noisy to gate on, so they are only listed.
+"""
+
+import csv
+import math
+import sys
+
+# per operation, from the medians of the repetitions
+METRICS = ["write-op [s]", "write-other-op [s]", "read-op [s]",
+           "read-other-op [s]", "create-p50 [s]", "select-p50 [s]",
+           "write-p50 [s]", "read-p50 [s]", "between-cases [s]"]
+
+# differences below this are timer noise [s]
+FLOOR = 1.0e-7
+
+
+def summarize(fname):
+    with open(fname, newline="") as f:
+        rows = list(csv.DictReader(f))
+    out = csv.writer(sys.stdout)
+    out.writerow(["case-key", "version", "repetitions", "wall-median [s]",
+                  "wall-stddev [s]"] + METRICS)
+    for i, r in enumerate(rows):
+        ops = float(r["steps"])*float(r["arrays"])
+        wph = float(r["write-phase-max-median [s]"])
+        wio = float(r["write-max-median [s]"])
+        rph = float(r["read-phase-max-median [s]"])
+        rio = float(r["read-max-median [s]"])
+        # reporting the case (the compression ratio, the results, but no du
+        # in memory), cleaning up, and setting up the next one
+        gap = ""
+        if i + 1 < len(rows):
+            gap = "%.6e" % (float(rows[i+1]["case-begin [s]"]) -
+                            float(r["case-end [s]"]))
+        out.writerow([r["case-key"], r["version"], r["repetitions"],
+                      r["wall-median [s]"], r["wall-stddev [s]"],
+                      "%.6e" % (wio/ops), "%.6e" % ((wph - wio)/ops),
+                      "%.6e" % (rio/ops), "%.6e" % ((rph - rio)/ops),
+                      r["create-p50 [s]"], r["select-p50 [s]"],
+                      r["write-p50 [s]"], r["read-p50 [s]"], gap])
+
+
+def load(fname):
+    with open(fname, newline="") as f:
+        return {r["case-key"]: r for r in csv.DictReader(f)}
+
+
+def compare(ref_name, cur_name, tolerance):
+    ref, cur = load(ref_name), load(cur_name)
+    keys = [k for k in cur if k in ref]
+    if not keys:
+        print("No cases in common.")
+        return 1
+    print("%d cases (%d only in %s, %d only in %s)" %
+          (len(keys), len(ref) - len(keys), ref_name,
+           len(cur) - len(keys), cur_name))
+    status = 0
+    for m in METRICS:
+        logs, worst = [], []
+        for k in keys:
+            if ref[k][m] == "" or cur[k][m] == "":
+                continue
+            a, b = float(ref[k][m]), float(cur[k][m])
+            if a <= FLOOR or b <= FLOOR or abs(b - a) <= FLOOR:
+                continue
+            logs.append(math.log(b/a))
+            worst.append((b/a, k))
+        if not logs:
+            continue
+        g = math.exp(sum(logs)/len(logs))
+        flag = "REGRESSION" if g > 1.0 + tolerance else "ok"
+        if g > 1.0 + tolerance:
+            status = 1
+        print("%-20s %7.3f  %s" % (m, g, flag))
+        for ratio, k in sorted(worst, reverse=True)[:3]:
+            if ratio > 1.0 + tolerance:
+                print("    %7.3f  %s" % (ratio, k))
+    return status
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3 and sys.argv[1] == "summarize":
+        summarize(sys.argv[2])
+    elif len(sys.argv) in (4, 5) and sys.argv[1] == "compare":
+        tol = float(sys.argv[4]) if len(sys.argv) == 5 else 0.10
+        sys.exit(compare(sys.argv[2], sys.argv[3], tol))
+    else:
+        print(__doc__)
+        sys.exit(2)
@@ -7,7 +7,8 @@ cd $HOME/hdf5
 ./autogen.sh
 ./configure --prefix=$HOME/.local --enable-build-mode=production \
   --enable-shared --enable-static --enable-optimization=high \
-  --enable-parallel --disable-hl
+  --enable-parallel --disable-hl \
+  --enable-ros3-vfd # for object-store-bench.sh (needs libcurl and libssl)
 make -j8
 make install
 
@@ -0,0 +1,63 @@
+#!/bin/bash -x
+#
+# Benchmark reads straight from object storage: write each case to the local
+# scratch disk, upload it to a Cloud Storage bucket, and read it back
+# through the HDF5 ros3 VFD (HDF5 configured with --enable-ros3-vfd, see
+# doit.sh). The chunked and contiguous layouts are both in the sweep.
+#
+# ros3 signs requests with HMAC keys, via the S3-compatible XML API:
+#   gsutil hmac create <service-account-email>
+#   export AWS_ACCESS_KEY_ID=<access id> AWS_SECRET_ACCESS_KEY=<secret>
+# Without keys, the bucket (prefix) must be publicly readable.
+#
+# Configure the following environmental variables as required:
+BUCKET=${BUCKET:-hdf5-iotest-$USER}
+PREFIX=${PREFIX:-iotest}
+LOCATION=${LOCATION:-us-central1}
+SCRATCH_MOUNT=${SCRATCH_MOUNT:-/mnt/scratch}
+RANKS=${RANKS:-4}
+IOTEST=${IOTEST:-$HOME/hdf5-iotest/src/hdf5_iotest}
+
+gsutil ls -b gs://$BUCKET > /dev/null 2>&1 || \
+  gsutil mb -l $LOCATION gs://$BUCKET
+
+cd $SCRATCH_MOUNT
+
+cat > object-store.ini <<EOT
+[DEFAULT]
+version = 0
+steps = 20
+arrays = 50
+rows = 1024
+columns = 1024
+process-rows = 1
+process-columns = $RANKS
+scaling = weak
+alignment-increment = 1
+alignment-threshold = 0
+meta-block-size = 2048
+single-process = posix
+mpi-io = independent
+hdf5-file = $SCRATCH_MOUNT/object-store.h5
+csv-file = $SCRATCH_MOUNT/object-store.csv
+# paged files, so that the page buffer applies to the reads
+file-space-strategy = fsm-aggr, page
+file-space-page-size = 4194304
+read-mode = object-store
+read-patterns = same-as-write, time-series, sub-box
+upload-command = gsutil -q cp {} gs://$BUCKET/$PREFIX/
+object-store-url = https://storage.googleapis.com/$BUCKET/$PREFIX
+object-store-region = ${AWS_ACCESS_KEY_ID:+auto}
+object-store-page-buffer = 67108864:0:0
+repetitions = 3
+EOT
+
+mpirun -n $RANKS $IOTEST object-store.ini | tee object-store.txt
+
+# the latency and throughput columns by layout
+python3 - <<EOT
+import pandas as pd
+df = pd.read_csv("object-store.csv")
+print(df.groupby(["layout", "fspace-strategy"])[
+    ["open-max [s]", "first-byte-max [s]", "read-bw-steady [GiB/s]"]].mean())
+EOT
@@ -0,0 +1,141 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "aggregate.h"
+
+#include <assert.h>
+#include <string.h>
+
+void node_tiles(MPI_Comm node_comm, MPI_Comm io_comm, int* tiles)
+{
+  int node_size, node_rank, io_rank, offset = 0, tile;
+
+  MPI_Comm_size(node_comm, &node_size);
+  MPI_Comm_rank(node_comm, &node_rank);
+
+  /* the first tile of a node follows the tiles of the nodes before it */
+  if (node_rank == 0)
+    {
+      MPI_Comm_rank(io_comm, &io_rank);
+      MPI_Exscan(&node_size, &offset, 1, MPI_INT, MPI_SUM, io_comm);
+      if (io_rank == 0) /* undefined for the first node */
+        offset = 0;
+    }
+  MPI_Bcast(&offset, 1, MPI_INT, 0, node_comm);
+
+  tile = offset + node_rank;
+  MPI_Allgather(&tile, 1, MPI_INT, tiles, 1, MPI_INT, MPI_COMM_WORLD);
+}
+
+int node_band(const configuration* pconfig, MPI_Comm node_comm,
+              unsigned int band[2])
+{
+  int n, nmin, nmax;
+  unsigned int node_size;
+
+  MPI_Comm_size(node_comm, &n);
+  MPI_Allreduce(&n, &nmin, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(&n, &nmax, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  node_size = (unsigned int) n;
+
+  band[0] = band[1] = 0;
+  if (nmin != nmax)
+    return -1;
+
+  if (pconfig->proc_cols % node_size == 0)
+    { /* a piece of a row of tiles */
+      band[0] = 1;
+      band[1] = node_size;
+    }
+  else if (node_size % pconfig->proc_cols == 0 &&
+           pconfig->proc_rows % (node_size / pconfig->proc_cols) == 0)
+    { /* whole rows of tiles */
+      band[0] = node_size / pconfig->proc_cols;
+      band[1] = pconfig->proc_cols;
+    }
+  else
+    return -1;
+
+  return 0;
+}
+
+void create_aggregator(MPI_Comm node_comm, const unsigned int band[2],
+                       unsigned int row, unsigned int col,
+                       size_t my_rows, size_t my_cols, aggregator* pa)
+{
+  const size_t band_size = band[0]*my_rows*band[1]*my_cols;
+  MPI_Aint win_size;
+  int disp_unit;
+  double* base;
+
+  memset(pa, 0, sizeof(aggregator));
+  pa->node_comm = node_comm;
+  MPI_Comm_rank(node_comm, &pa->node_rank);
+  pa->band_cols = band[1]*my_cols;
+  pa->offset = row*my_rows*pa->band_cols + col*my_cols;
+
+  /* the aggregator holds the window, the others just map it */
+  win_size = (pa->node_rank == 0) ? (MPI_Aint)(2*band_size*sizeof(double)) : 0;
+  assert(MPI_Win_allocate_shared(win_size, sizeof(double), MPI_INFO_NULL,
+                                 node_comm, &base, &pa->win) == MPI_SUCCESS);
+  assert(MPI_Win_shared_query(pa->win, 0, &win_size, &disp_unit, &base) ==
+         MPI_SUCCESS);
+  pa->slot[0] = base;
+  pa->slot[1] = base + band_size;
+
+  /* passive target epoch, the node barriers order the loads and stores */
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, pa->win);
+}
+
+double* aggregate_tile(aggregator* pa, const generator* pg,
+                       unsigned int istep, unsigned int iarray,
+                       double* write_time, metrics* pm)
+{
+  /* The aggregator writes a band before it joins the barrier of the next
+     one, so two slots are enough to never overwrite a band in flight */
+  double* band = pa->slot[pa->count++ % 2];
+  double t;
+
+  generate_tile(pg, band + pa->offset, istep, iarray, pm);
+
+  t = -MPI_Wtime();
+  MPI_Win_sync(pa->win);
+  MPI_Barrier(pa->node_comm);
+  MPI_Win_sync(pa->win);
+  t += MPI_Wtime();
+  *write_time += t;
+  pm->aggregate += t;
+
+  return band;
+}
+
+void feed_aggregator(const configuration* pconfig, aggregator* pa,
+                     const generator* pg, step_log* plog,
+                     double* write_time, metrics* pm)
+{
+  unsigned int istep, iarray;
+
+  /* the order of write_test */
+  for (istep = 0; istep < pconfig->steps; ++istep)
+    {
+      for (iarray = 0; iarray < pconfig->arrays; ++iarray)
+        aggregate_tile(pa, pg, istep, iarray, write_time, pm);
+      log_step(plog, istep, *write_time);
+    }
+}
+
+void close_aggregator(aggregator* pa)
+{
+  MPI_Win_unlock_all(pa->win);
+  MPI_Win_free(&pa->win);
+}
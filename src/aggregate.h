@@ -0,0 +1,79 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include "configuration.h"
+#include "generators.h"
+#include "metrics.h"
+#include "step_log.h"
+
+#include <stddef.h>
+
+/*
+ * Node-aware decomposition and two-level aggregation.
+ *
+ * With the node-aware mapping, the ranks of a node own consecutive tiles
+ * (in row-major order), nodes in the order of their first rank, i.e., each
+ * node owns a band of the global array, regardless of how the ranks were
+ * placed. If the bands are rectangles of the same shape, the ranks of a
+ * node can generate their tiles straight into a shared-memory window
+ * (zero-copy), and one aggregator per node writes the merged band.
+ */
+
+/* The node-aware tile index of each rank (collective) */
+
+extern void node_tiles(MPI_Comm node_comm, MPI_Comm io_comm, int* tiles);
+
+/* The extent (tile rows x tile columns) of a node's band, or -1 if the
+   nodes' tiles don't form rectangles of the same shape (collective) */
+
+extern int node_band(const configuration* pconfig, MPI_Comm node_comm,
+                     unsigned int band[2]);
+
+typedef struct
+{
+  MPI_Comm     node_comm;
+  int          node_rank;       /* 0 is the aggregator */
+  MPI_Win      win;
+  double*      slot[2];         /* double-buffered bands in the window */
+  size_t       band_cols;       /* the band's row length */
+  size_t       offset;          /* of the rank's tile in the band */
+  unsigned int count;           /* tiles aggregated so far */
+} aggregator;
+
+/* Create the shared window of a node (collective on node_comm). The rank's
+   tile is the tile at (row, col) of band. */
+
+extern void create_aggregator(MPI_Comm node_comm, const unsigned int band[2],
+                              unsigned int row, unsigned int col,
+                              size_t my_rows, size_t my_cols, aggregator* pa);
+
+/* Generate the rank's tile of a (step, array) in place, and wait for the
+   other ranks of the node. Returns the band to write. The wait counts as
+   write time. */
+
+extern double* aggregate_tile(aggregator* pa, const generator* pg,
+                              unsigned int istep, unsigned int iarray,
+                              double* write_time, metrics* pm);
+
+/* The write phase of a rank other than the aggregator */
+
+extern void feed_aggregator(const configuration* pconfig, aggregator* pa,
+                            const generator* pg, step_log* plog,
+                            double* write_time, metrics* pm);
+
+extern void close_aggregator(aggregator* pa);
+
+#endif
@@ -14,6 +14,8 @@
 #include "configuration.h"
 
 #include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,6 +47,451 @@ parse_unit(const char *str_in, unsigned long long *num, char **unit_str)
     return 0;
 }
 
+const char* scaling_names[SCALING_COUNT] = { "weak", "strong" };
+
+const char* slowdim_names[SLOWDIM_COUNT] = { "step", "array" };
+
+const char* layout_names[LAYOUT_COUNT] = { "contiguous", "chunked" };
+
+const char* fill_names[FILL_COUNT] = { "true", "false" };
+
+const char* file_mode_names[FILE_MODE_COUNT] =
+  { "shared", "file-per-process", "subfiling" };
+
+const char* read_mode_names[READ_MODE_COUNT] = { "warm", "cold", "object-store" };
+
+const char* read_pattern_names[READ_PATTERN_COUNT] =
+  { "same-as-write", "time-series", "sub-box", "random-tiles", "broadcast" };
+
+const char* fspace_strategy_names[FSPACE_STRATEGY_COUNT] =
+  { "fsm-aggr", "page", "aggr", "none" };
+
+const char* datatype_names[DATATYPE_COUNT] =
+  { "double", "float", "int16", "compound" };
+
+const char* generator_names[GENERATOR_COUNT] =
+  { "constant", "paraboloid", "noisy", "random", "replay" };
+
+const char* aggregation_names[AGGREGATION_COUNT] =
+  { "none", "node-map", "node-agg" };
+
+/* Copy a string into a buffer of size bytes, rejecting (rather than
+   truncating) values that don't fit */
+
+static int
+copy_value(const char *str, char *buf, size_t size)
+{
+    if (strlen(str) >= size) {
+        printf("Value \"%.32s...\" is too long (%zu characters at most).\n",
+               str, size - 1);
+        return -1;
+    }
+    strcpy(buf, str);
+    return 0;
+}
+
+/* Parse a single name into its index */
+
+static int
+parse_name(const char *str, const char* names[], unsigned int count,
+           unsigned int *index)
+{
+    unsigned int i;
+
+    for (i = 0; i < count; ++i)
+        if (strcmp(str, names[i]) == 0) {
+            *index = i;
+            return 0;
+        }
+    printf("Unknown value \"%s\".\n", str);
+    return -1;
+}
+
+/* Parse a comma-separated list of names into a bit mask of their indices */
+
+static int
+parse_names(const char *str_in, const char* names[], unsigned int count,
+            unsigned int *mask)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int i;
+
+    *mask = 0;
+    while (ptr != NULL) {
+        for (i = 0; i < count; ++i)
+            if (strcmp(ptr, names[i]) == 0)
+                break;
+        if (i == count) {
+            printf("Unknown value \"%s\".\n", ptr);
+            free(str);
+            return -1;
+        }
+        *mask |= 1u << i;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    return 0;
+}
+
+/* Parse a comma-separated list of file modes */
+
+static int
+parse_file_modes(const char *str_in, unsigned int *modes)
+{
+    if (parse_names(str_in, file_mode_names, FILE_MODE_COUNT, modes) < 0)
+        return -1;
+#ifndef H5_HAVE_SUBFILING_VFD
+    if (*modes & (1u << 2)) {
+        printf("SUBFILING requires HDF5 built with the subfiling VFD \n");
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+/* Parse a comma-separated list of chunk shape multipliers, e.g., 1x1, 2x4 */
+
+static int
+parse_chunk_scales(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP ||
+            sscanf(ptr, "%lfx%lf", &pconfig->chunk_scales[n][0],
+                   &pconfig->chunk_scales[n][1]) != 2 ||
+            pconfig->chunk_scales[n][0] <= 0.0 ||
+            pconfig->chunk_scales[n][1] <= 0.0) {
+            printf("Invalid chunk scale \"%s\".\n", ptr);
+            free(str);
+            return -1;
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->nchunk_scales = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Parse a comma-separated list of nslots:nbytes:w0 chunk caches, or default */
+
+static int
+parse_chunk_caches(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+    chunk_cache *pc;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP) {
+            printf("Too many chunk caches.\n");
+            free(str);
+            return -1;
+        }
+        pc = &pconfig->chunk_caches[n];
+        if (strcmp(ptr, "default") == 0) {
+            pc->nslots = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
+            pc->nbytes = H5D_CHUNK_CACHE_NBYTES_DEFAULT;
+            pc->w0     = H5D_CHUNK_CACHE_W0_DEFAULT;
+        } else if (sscanf(ptr, "%zu:%zu:%lf", &pc->nslots, &pc->nbytes, &pc->w0) != 3 ||
+                   pc->w0 < 0.0 || pc->w0 > 1.0) {
+            printf("Invalid chunk cache \"%s\" (nslots:nbytes:w0).\n", ptr);
+            free(str);
+            return -1;
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->nchunk_caches = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Parse a comma-separated list of file space page sizes */
+
+static int
+parse_page_sizes(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP) {
+            printf("Too many page sizes.\n");
+            free(str);
+            return -1;
+        }
+        pconfig->page_sizes[n] = (hsize_t) atoll(ptr);
+        if (pconfig->page_sizes[n] < 512) {
+            printf("Invalid page size \"%s\" (>= 512).\n", ptr);
+            free(str);
+            return -1;
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->npage_sizes = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Parse a comma-separated list of thread counts */
+
+static int
+parse_thread_counts(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP) {
+            printf("Too many thread counts.\n");
+            free(str);
+            return -1;
+        }
+        pconfig->thread_counts[n] = (unsigned int) atol(ptr);
+        if (pconfig->thread_counts[n] < 1) {
+            printf("Invalid thread count \"%s\" (>= 1).\n", ptr);
+            free(str);
+            return -1;
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->nthread_counts = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Parse a page buffer, off or size:min-meta%:min-raw%, e.g., 4194304:20:20 */
+
+static int
+parse_page_buffer(const char *str, page_buffer *pb)
+{
+    if (strcmp(str, "off") == 0) {
+        pb->size = 0;
+        pb->min_meta_perc = pb->min_raw_perc = 0;
+    } else if (sscanf(str, "%zu:%u:%u", &pb->size, &pb->min_meta_perc,
+                      &pb->min_raw_perc) != 3 || pb->size == 0 ||
+               pb->min_meta_perc + pb->min_raw_perc > 100) {
+        printf("Invalid page buffer \"%s\" (size:min-meta%%:min-raw%%).\n", str);
+        return -1;
+    }
+    return 0;
+}
+
+/* Parse a comma-separated list of page buffers, e.g., off, 4194304:20:20 */
+
+static int
+parse_page_buffers(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP) {
+            printf("Too many page buffers.\n");
+            free(str);
+            return -1;
+        }
+        if (parse_page_buffer(ptr, &pconfig->page_buffers[n]) < 0) {
+            free(str);
+            return -1;
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->npage_buffers = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Parse a comma-separated list of metadata cache configurations, e.g.,
+   default, 2097152:33554432, 33554432:33554432:no-evict */
+
+static int
+parse_mdc_configs(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+    unsigned int n = 0;
+    mdc_config *pc;
+    char flag[16];
+    int count;
+
+    while (ptr != NULL) {
+        if (n == MAX_SWEEP) {
+            printf("Too many metadata cache configurations.\n");
+            free(str);
+            return -1;
+        }
+        pc = &pconfig->mdc_configs[n];
+        pc->initial_size = pc->max_size = 0;
+        pc->evictions = 1;
+        flag[0] = '\0';
+        if (strcmp(ptr, "default") != 0) {
+            count = sscanf(ptr, "%zu:%zu:%15s", &pc->initial_size, &pc->max_size, flag);
+            if (count == 3 && strcmp(flag, "no-evict") == 0)
+                pc->evictions = 0;
+            else if (count != 2)
+                count = -1;
+            if (count < 0 || pc->initial_size == 0 ||
+                pc->initial_size > pc->max_size) {
+                printf("Invalid metadata cache \"%s\" (initial:max[:no-evict]).\n", ptr);
+                free(str);
+                return -1;
+            }
+        }
+        ++n;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    pconfig->nmdc_configs = n;
+    return (n > 0) ? 0 : -1;
+}
+
+/* Dataset filter presets. Their parameters replace the client data from
+   cd_values[first] on, which is a double for the ZFP modes (as laid out by
+   H5Z-ZFP's H5Pset_zfp_*_cdata macros). The first four Blosc values are
+   filled in by the filter. */
+
+typedef struct
+{
+  const char*   name;
+  H5Z_filter_t  id;
+  unsigned int  flags;
+  size_t        cd_nelmts;
+  unsigned int  cd_values[7];
+  size_t        first;
+  double        dflt;           /* > 0 for a double parameter */
+} filter_preset;
+
+static const filter_preset filter_presets[] =
+  {
+    { "none",           H5Z_FILTER_NONE,    0, 0, { 0 }, 0, 0.0 },
+    { "gzip",           H5Z_FILTER_DEFLATE, H5Z_FLAG_OPTIONAL, 1, { 6 }, 0, 0.0 },
+    { "szip",           H5Z_FILTER_SZIP,    H5Z_FLAG_OPTIONAL, 2,
+      { H5_SZIP_NN_OPTION_MASK, 16 }, 1, 0.0 },
+    { "szip-ec",        H5Z_FILTER_SZIP,    H5Z_FLAG_OPTIONAL, 2,
+      { H5_SZIP_EC_OPTION_MASK, 16 }, 1, 0.0 },
+    { "zstd",           H5Z_FILTER_ZSTD,    H5Z_FLAG_MANDATORY, 1, { 3 }, 0, 0.0 },
+    { "lz4",            H5Z_FILTER_LZ4,     H5Z_FLAG_MANDATORY, 1, { 0 }, 0, 0.0 },
+    /* clevel, shuffle, compressor */
+    { "blosc",          H5Z_FILTER_BLOSC,   H5Z_FLAG_MANDATORY, 7,
+      { 0, 0, 0, 0, 5, 1, 0 }, 4, 0.0 },
+    { "blosc-lz4",      H5Z_FILTER_BLOSC,   H5Z_FLAG_MANDATORY, 7,
+      { 0, 0, 0, 0, 5, 1, 1 }, 4, 0.0 },
+    { "blosc-zstd",     H5Z_FILTER_BLOSC,   H5Z_FLAG_MANDATORY, 7,
+      { 0, 0, 0, 0, 5, 1, 5 }, 4, 0.0 },
+    /* lossy */
+    { "zfp-rate",       H5Z_FILTER_ZFP,     H5Z_FLAG_MANDATORY, 4, { 1 }, 2, 16.0 },
+    { "zfp-precision",  H5Z_FILTER_ZFP,     H5Z_FLAG_MANDATORY, 3, { 2, 0, 32 }, 2, 0.0 },
+    { "zfp-accuracy",   H5Z_FILTER_ZFP,     H5Z_FLAG_MANDATORY, 4, { 3 }, 2, 1.0e-6 },
+    { "zfp-reversible", H5Z_FILTER_ZFP,     H5Z_FLAG_MANDATORY, 1, { 5 }, 1, 0.0 }
+  };
+
+/* Parse a preset or a filter id, each followed by colon-separated
+   parameters, e.g., zstd:5 or 32015:5 */
+
+static int
+parse_compression(const char *str_in, dataset_filter *pf)
+{
+    char *str = strdup(str_in);
+    char *par[MAX_CD_VALUES];
+    char *name = str;
+    char *ptr = strchr(str, ':');
+    char *endptr;
+    size_t npar = 0, i;
+    int ok = (name[0] != '\0' && strlen(str_in) < sizeof(pf->label));
+
+    /* not strtok, the caller is in the middle of a list */
+    memset(pf, 0, sizeof(dataset_filter));
+    while (ok && ptr != NULL) {
+        *ptr++ = '\0';
+        if (npar == MAX_CD_VALUES)
+            ok = 0;
+        else
+            par[npar++] = ptr;
+        ptr = strchr(ptr, ':');
+    }
+
+    if (ok && isdigit((unsigned char)name[0])) { /* a filter id and its client data */
+        pf->id = (H5Z_filter_t) strtol(name, &endptr, 0);
+        pf->flags = H5Z_FLAG_MANDATORY;
+        ok = (*endptr == '\0' && pf->id > 0 && pf->id <= H5Z_FILTER_MAX);
+        for (i = 0; ok && i < npar; ++i) {
+            pf->cd_values[i] = (unsigned int) strtoul(par[i], &endptr, 0);
+            ok = (*endptr == '\0');
+        }
+        pf->cd_nelmts = npar;
+    } else if (ok) {
+        const filter_preset *pp = NULL;
+        for (i = 0; i < sizeof(filter_presets)/sizeof(filter_preset); ++i)
+            if (strcmp(name, filter_presets[i].name) == 0)
+                pp = &filter_presets[i];
+        ok = (pp != NULL);
+        if (ok) {
+            pf->id = pp->id;
+            pf->flags = pp->flags;
+            pf->cd_nelmts = pp->cd_nelmts;
+            memcpy(pf->cd_values, pp->cd_values, sizeof(pp->cd_values));
+            if (pp->dflt > 0.0) {
+                double d = (npar > 0) ? strtod(par[0], &endptr) : pp->dflt;
+                ok = (npar <= 1 && d > 0.0 && (npar == 0 || *endptr == '\0'));
+                memcpy(&pf->cd_values[pp->first], &d, sizeof(double));
+            } else {
+                ok = (npar <= pp->cd_nelmts - pp->first);
+                for (i = 0; ok && i < npar; ++i) {
+                    pf->cd_values[pp->first + i] = (unsigned int) strtoul(par[i], &endptr, 0);
+                    ok = (*endptr == '\0');
+                }
+            }
+        }
+    }
+    free(str);
+
+    if (!ok) {
+        printf("Invalid dataset filter \"%s\" (preset or id, and parameters).\n", str_in);
+        return -1;
+    }
+    strcpy(pf->label, str_in);
+    return 0;
+}
+
+/* Parse a comma-separated list of dataset filters, e.g., none, gzip:6,
+   zfp-rate:8, and add them to the ones configured so far */
+
+static int
+parse_compressions(const char *str_in, configuration *pconfig)
+{
+    char *str = strdup(str_in);
+    char *ptr = strtok(str, ", ");
+
+    while (ptr != NULL) {
+        if (pconfig->ncompressions == MAX_SWEEP) {
+            printf("Too many dataset filters.\n");
+            free(str);
+            return -1;
+        }
+        if (parse_compression(ptr, &pconfig->compressions[pconfig->ncompressions]) < 0) {
+            free(str);
+            return -1;
+        }
+        ++pconfig->ncompressions;
+        ptr = strtok(NULL, ", ");
+    }
+    free(str);
+    return 0;
+}
+
 int
 parse_time(const char *str_in, duration *time)
 {
@@ -98,11 +545,14 @@ int check_options
   } else if (MATCH(section, "process-columns")) {
     pconfig->proc_cols = (unsigned int) atoi(value);
   } else if (MATCH(section, "scaling")) {
-    strncpy(pconfig->scaling, value, 15);
+    if (parse_name(value, scaling_names, SCALING_COUNT, &pconfig->scaling) < 0)
+      return 0;
   } else if (MATCH(section, "dataset-rank")) {
     pconfig->rank = (unsigned int) atoi(value);
   } else if (MATCH(section, "slowest-dimension")) {
-    strncpy(pconfig->slowest_dimension, value, 15);
+    if (parse_name(value, slowdim_names, SLOWDIM_COUNT,
+                   &pconfig->slowest_dimension) < 0)
+      return 0;
   } else if (MATCH(section, "libver-bound-low")) {
     strncpy(pconfig->libver_bound_low, value, 15);
   } else if (MATCH(section, "libver-bound-high")) {
@@ -114,11 +564,22 @@ int check_options
   } else if (MATCH(section, "meta-block-size")) {
     pconfig->meta_block_size = (hsize_t) atol(value);
   } else if (MATCH(section, "layout")) {
-    strncpy(pconfig->layout, value, 15);
+    if (parse_name(value, layout_names, LAYOUT_COUNT, &pconfig->layout) < 0)
+      return 0;
   } else if (MATCH(section, "fill-values")) {
-    strncpy(pconfig->fill_values, value, 7);
+    if (parse_name(value, fill_names, FILL_COUNT, &pconfig->fill_values) < 0)
+      return 0;
   } else if (MATCH(section, "single-process")) {
     strncpy(pconfig->single_process, value, 15);
+#ifndef H5_HAVE_DIRECT
+    if (strncmp(pconfig->single_process, "direct", 16) == 0) {
+      printf("DIRECT requires HDF5 built with the direct VFD \n");
+      return 0;
+    }
+#endif
+  } else if (MATCH(section, "core-backing-store")) {
+      pconfig->core_backing_store = (strcmp(value, "true") == 0 ||
+                                     strcmp(value, "1") == 0);
   } else if (MATCH(section, "mpi-io")) {
     strncpy(pconfig->mpi_io, value, 15);
   } else if (MATCH(section, "split")) {
@@ -132,6 +593,20 @@ int check_options
       }
   } else if (MATCH(section, "csv-file")) {
     strncpy(pconfig->csv_file, value, PATH_MAX-1);
+  } else if (MATCH(section, "markers")) {
+      pconfig->markers = (strcmp(value, "true") == 0 ||
+                          strcmp(value, "1") == 0);
+  } else if (MATCH(section, "warmup")) {
+    pconfig->warmups = (unsigned int)atol(value);
+  } else if (MATCH(section, "repetitions")) {
+    pconfig->repetitions = (unsigned int)atol(value);
+  } else if (MATCH(section, "reuse-file")) {
+      pconfig->reuse_file = (strcmp(value, "true") == 0 ||
+                             strcmp(value, "1") == 0);
+  } else if (MATCH(section, "ci-target")) {
+    pconfig->ci_target = atof(value);
+  } else if (MATCH(section, "step-csv-file")) {
+    strncpy(pconfig->step_csv_file, value, PATH_MAX-1);
   } else if (MATCH(section, "restart")) {
     pconfig->restart = (unsigned int) atol(value);
   } else if (MATCH(section, "async")) {
@@ -140,6 +615,124 @@ int check_options
       return 0;
 #endif
       pconfig->async = (unsigned int) atol(value);
+  } else if (MATCH(section, "multi-dataset")) {
+#if !H5_VERSION_GE(1,14,0)
+      printf("MULTI-DATASET only supported for HDF5 version >= 1.14 \n");
+      return 0;
+#endif
+      pconfig->multi_dataset = (strcmp(value, "true") == 0 ||
+                                strcmp(value, "1") == 0);
+  } else if (MATCH(section, "append")) {
+      pconfig->append = (strcmp(value, "true") == 0 ||
+                         strcmp(value, "1") == 0);
+  } else if (MATCH(section, "precreate")) {
+      pconfig->precreate = (strcmp(value, "true") == 0 ||
+                            strcmp(value, "1") == 0);
+  } else if (MATCH(section, "selection-cache")) {
+      pconfig->selection_cache = (strcmp(value, "true") == 0 ||
+                                  strcmp(value, "1") == 0);
+  } else if (MATCH(section, "file-mode")) {
+    if (parse_file_modes(value, &pconfig->file_modes) < 0)
+      return 0;
+  } else if ((MATCH(section, "include")) || (MATCH(section, "exclude"))) {
+    /* filters accumulate, every line is a filter of its own */
+    unsigned int *pn = (strcmp(name, "include") == 0) ?
+      &pconfig->nincludes : &pconfig->nexcludes;
+    char (*filters)[FILTER_LEN] = (strcmp(name, "include") == 0) ?
+      pconfig->includes : pconfig->excludes;
+    if (*pn == MAX_FILTERS || strlen(value) >= FILTER_LEN ||
+        strspn(value, " ") == strlen(value)) {
+      printf("Invalid or too many %s filters.\n", name);
+      return 0;
+    }
+    strcpy(filters[(*pn)++], value);
+  } else if (MATCH(section, "chunk-scale")) {
+    if (parse_chunk_scales(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "chunk-cache")) {
+    if (parse_chunk_caches(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "subfiling-stripe-size")) {
+    pconfig->subfiling_stripe_size = (unsigned long long) atoll(value);
+  } else if (MATCH(section, "subfiling-ioc-per-node")) {
+    pconfig->subfiling_ioc_per_node = (unsigned int) atol(value);
+  } else if (MATCH(section, "buffer-alignment")) {
+    pconfig->buffer_alignment = (unsigned long long) atoll(value);
+  } else if (MATCH(section, "huge-pages")) {
+    pconfig->huge_pages = (unsigned int) atol(value);
+  } else if (MATCH(section, "read-mode")) {
+    if (parse_names(value, read_mode_names, READ_MODE_COUNT,
+                    &pconfig->read_modes) < 0)
+      return 0;
+  } else if (MATCH(section, "read-patterns")) {
+    if (parse_names(value, read_pattern_names, READ_PATTERN_COUNT,
+                    &pconfig->read_patterns) < 0)
+      return 0;
+  } else if (MATCH(section, "time-series-array")) {
+    pconfig->time_series_array = (unsigned int)atol(value);
+  } else if (MATCH(section, "random-tiles")) {
+    pconfig->random_tiles = (unsigned int)atol(value);
+  } else if (MATCH(section, "read-seed")) {
+    pconfig->read_seed = (unsigned long)atol(value);
+  } else if (MATCH(section, "read-shift")) {
+    pconfig->read_shift = atoi(value);
+  } else if (MATCH(section, "drop-cache-command")) {
+    if (copy_value(value, pconfig->drop_cache_command, PATH_MAX) < 0)
+      return 0;
+  } else if (MATCH(section, "upload-command")) {
+    if (copy_value(value, pconfig->upload_command, PATH_MAX) < 0)
+      return 0;
+  } else if (MATCH(section, "object-store-url")) {
+    if (copy_value(value, pconfig->object_store_url, PATH_MAX) < 0)
+      return 0;
+  } else if (MATCH(section, "object-store-region")) {
+    strncpy(pconfig->object_store_region, value,
+            sizeof(pconfig->object_store_region) - 1);
+  } else if (MATCH(section, "object-store-page-buffer")) {
+    if (parse_page_buffer(value, &pconfig->object_store_pbuf) < 0)
+      return 0;
+  } else if (MATCH(section, "file-space-strategy")) {
+    if (parse_names(value, fspace_strategy_names, FSPACE_STRATEGY_COUNT,
+                    &pconfig->fspace_strategies) < 0)
+      return 0;
+  } else if (MATCH(section, "file-space-page-size")) {
+    if (parse_page_sizes(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "threads-per-rank")) {
+    if (parse_thread_counts(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "page-buffer")) {
+    if (parse_page_buffers(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "metadata-cache")) {
+    if (parse_mdc_configs(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "data-generator")) {
+    if (parse_names(value, generator_names, GENERATOR_COUNT,
+                    &pconfig->generators) < 0)
+      return 0;
+  } else if (MATCH(section, "datatype")) {
+    if (parse_names(value, datatype_names, DATATYPE_COUNT,
+                    &pconfig->datatypes) < 0)
+      return 0;
+  } else if (MATCH(section, "type-conversion")) {
+      pconfig->type_conversion = (strcmp(value, "true") == 0 ||
+                                  strcmp(value, "1") == 0);
+  } else if (MATCH(section, "replay-file")) {
+    if (copy_value(value, pconfig->replay_file, PATH_MAX) < 0)
+      return 0;
+  } else if (MATCH(section, "aggregation")) {
+    if (parse_names(value, aggregation_names, AGGREGATION_COUNT,
+                    &pconfig->aggregations) < 0)
+      return 0;
+  } else if (MATCH(section, "replay-dataset")) {
+    strncpy(pconfig->replay_dataset, value, 255);
+  } else if (MATCH(section, "coll-metadata")) {
+    const char* modes[2] = { "0", "1" };
+    if (parse_names(value, modes, 2, &pconfig->coll_metadata_modes) < 0)
+      return 0;
+  } else if (MATCH(section, "async-buffers")) {
+    pconfig->async_buffers = (unsigned int) atol(value);
   } else if (MATCH(section, "delay")) {
     duration time;
     if (parse_time(value, &time) < 0)
@@ -152,31 +745,27 @@ int check_options
     }
   } else if (MATCH(section, "one-case")) {
     pconfig->one_case = (unsigned int) atol(value);
-  } else if (MATCH(section, "gzip")) {
-    strncpy(pconfig->compress_type, "gzip", 15);
-    pconfig->compress_par[0] = (unsigned int) atol(value);
-  } else if (MATCH(section, "szip")) {
-    strncpy(pconfig->compress_type, "szip", 15);
+  } else if (MATCH(section, "compression")) {
+    if (parse_compressions(value, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "gzip")) { /* the level, same as compression = gzip:level */
     char tmp[32];
-    strncpy(tmp, value, 31);
-    char * pch;
-    pch = strtok (tmp, " ,");
-    int icnt = 0;
-    while (pch != NULL) {
-      if(icnt == 0) {
-        if ( strcmp(pch,"H5_SZIP_EC_OPTION_MASK") ) {
-          pconfig->compress_par[icnt] = H5_SZIP_EC_OPTION_MASK;
-        } else if ( strcmp(pch,"H5_SZIP_NN_OPTION_MASK") ) {
-          pconfig->compress_par[icnt] = H5_SZIP_NN_OPTION_MASK;
-        } else {
-          return 0;  /* invalid parameter, error */
-        }
-      } else if(icnt == 1) {
-        pconfig->compress_par[icnt] = (unsigned int) atol(pch);
-      }
-      pch = strtok (NULL, " ,");
-      icnt++;
-    }
+    snprintf(tmp, sizeof(tmp), "gzip:%u", (unsigned int) atol(value));
+    if (parse_compressions(tmp, pconfig) < 0)
+      return 0;
+  } else if (MATCH(section, "szip")) { /* options_mask, pixels_per_block */
+    char tmp[32], mask[32];
+    unsigned int ppb;
+    if (sscanf(value, " %31[^ ,] , %u", mask, &ppb) != 2)
+      return 0;
+    if (strcmp(mask, "H5_SZIP_NN_OPTION_MASK") == 0)
+      snprintf(tmp, sizeof(tmp), "szip:%u", ppb);
+    else if (strcmp(mask, "H5_SZIP_EC_OPTION_MASK") == 0)
+      snprintf(tmp, sizeof(tmp), "szip-ec:%u", ppb);
+    else
+      return 0;  /* invalid parameter, error */
+    if (parse_compressions(tmp, pconfig) < 0)
+      return 0;
   } else {
     return 0;  /* unknown name, error */
   }
@@ -184,6 +773,86 @@ int check_options
   return 1;
 }
 
+/* Add an MPI-IO hint with a comma-separated list of values */
+
+static int add_hint(configuration* pconfig, const char* name, const char* value)
+{
+  mpi_hint* ph;
+  char *str, *ptr;
+
+  if (pconfig->nhints == MAX_HINTS || strlen(name) >= sizeof(ph->key))
+    {
+      printf("Can't add MPI-IO hint \"%s\".\n", name);
+      return 0;
+    }
+  ph = &pconfig->hints[pconfig->nhints];
+  strncpy(ph->key, name, sizeof(ph->key)-1);
+  ph->nvalues = 0;
+
+  str = strdup(value);
+  ptr = strtok(str, ", ");
+  while (ptr != NULL)
+    {
+      if (ph->nvalues == MAX_SWEEP || strlen(ptr) >= sizeof(ph->values[0]))
+        {
+          printf("Invalid values for MPI-IO hint \"%s\".\n", name);
+          free(str);
+          return 0;
+        }
+      strncpy(ph->values[ph->nvalues++], ptr, sizeof(ph->values[0])-1);
+      ptr = strtok(NULL, ", ");
+    }
+  free(str);
+
+  if (ph->nvalues > 0)
+    ++pconfig->nhints;
+  return 1;
+}
+
+/* The number of hint combinations (the size of their cross product) */
+
+unsigned int hint_combinations(const configuration* pconfig)
+{
+  unsigned int i, result = 1;
+  for (i = 0; i < pconfig->nhints; ++i)
+    result *= pconfig->hints[i].nvalues;
+  return result;
+}
+
+/*
+ *
+ * Create the MPI info object for a combination of hint values, the first
+ * hint varies fastest
+ *
+ */
+
+MPI_Info select_hints(configuration* pconfig, unsigned int icombo)
+{
+  MPI_Info result = MPI_INFO_NULL;
+  unsigned int i, ivalue;
+  size_t len = 0;
+
+  strcpy(pconfig->hints_requested, "none");
+  if (pconfig->nhints == 0)
+    return result;
+
+  MPI_Info_create(&result);
+  pconfig->hints_requested[0] = '\0';
+  for (i = 0; i < pconfig->nhints; ++i)
+    {
+      ivalue = icombo % pconfig->hints[i].nvalues;
+      icombo /= pconfig->hints[i].nvalues;
+      MPI_Info_set(result, pconfig->hints[i].key, pconfig->hints[i].values[ivalue]);
+      len += snprintf(pconfig->hints_requested + len,
+                      sizeof(pconfig->hints_requested) - len, "%s%s=%s",
+                      (i > 0) ? ";" : "", pconfig->hints[i].key,
+                      pconfig->hints[i].values[ivalue]);
+      if (len >= sizeof(pconfig->hints_requested))
+        len = sizeof(pconfig->hints_requested) - 1;
+    }
+  return result;
+}
+
 int handler(void* user,
             const char* section,
             const char* name,
@@ -191,7 +860,11 @@ int handler(void* user,
 {
   configuration* pconfig = (configuration*)user;
 
-  if (strncmp(section, "DEFAULT", 7) == 0)
+  if (strcmp(section, "mpi-hints") == 0)
+    {
+      return add_hint(pconfig, name, value);
+    }
+  else if (strncmp(section, "DEFAULT", 7) == 0)
     {
       if (strcmp(section, "DEFAULT") == 0 && strcmp(name, "version") == 0)
         pconfig->version = atoi(value);
@@ -206,6 +879,165 @@ int handler(void* user,
   return 1;
 }
 
+/*
+ *
+ * Drop the dataset filters which can't encode, e.g., plugins not found on
+ * HDF5_PLUGIN_PATH, so that one missing filter doesn't spoil a sweep
+ *
+ */
+
+void check_compressions(configuration* pconfig)
+{
+  unsigned int i, n = 0, filter_info = 0;
+  htri_t avail;
+
+  for (i = 0; i < pconfig->ncompressions; ++i)
+    {
+      const dataset_filter* pf = &pconfig->compressions[i];
+      if (pf->id == H5Z_FILTER_NONE)
+        {
+          pconfig->compressions[n++] = *pf;
+          continue;
+        }
+      H5E_BEGIN_TRY {
+        avail = H5Zfilter_avail(pf->id);
+        if (avail > 0 && H5Zget_filter_info(pf->id, &filter_info) < 0)
+          avail = 0;
+      } H5E_END_TRY;
+      if (avail > 0 && (filter_info & H5Z_FILTER_CONFIG_ENCODE_ENABLED))
+        pconfig->compressions[n++] = *pf;
+      else
+        printf("Warning: dataset filter \"%s\" (%d) is not available, skipped.\n",
+               pf->label, (int) pf->id);
+    }
+  pconfig->ncompressions = n;
+}
+
+/*
+ *
+ * Broadcast the configuration. Most of its character buffers (paths,
+ * hints, filters) are empty or short, so they travel as length-prefixed
+ * strings, and the rest as is. The header catches mismatched builds.
+ *
+ */
+
+#define CONFIG_VERSION 1
+
+#define MAX_STRING_FIELDS (24 + MAX_HINTS*(1 + MAX_SWEEP) + 2*MAX_FILTERS)
+
+typedef struct
+{
+  size_t offset;
+  size_t size;
+} string_field;
+
+static int by_offset(const void* a, const void* b)
+{
+  const size_t x = ((const string_field*)a)->offset;
+  const size_t y = ((const string_field*)b)->offset;
+  return (x > y) - (x < y);
+}
+
+static unsigned int string_fields(const configuration* pc, string_field* f)
+{
+  unsigned int n = 0, i, j;
+
+#define ADD(member) \
+  (f[n].offset = (size_t)((const char*)(member) - (const char*)pc), \
+   f[n].size = sizeof(member), ++n)
+  ADD(pc->libver_bound_low);
+  ADD(pc->libver_bound_high);
+  ADD(pc->single_process);
+  ADD(pc->mpi_io);
+  ADD(pc->hdf5_file);
+  ADD(pc->csv_file);
+  ADD(pc->step_csv_file);
+  for (i = 0; i < MAX_HINTS; ++i)
+    {
+      ADD(pc->hints[i].key);
+      for (j = 0; j < MAX_SWEEP; ++j)
+        ADD(pc->hints[i].values[j]);
+    }
+  ADD(pc->hints_requested);
+  ADD(pc->hints_effective);
+  for (i = 0; i < MAX_FILTERS; ++i)
+    ADD(pc->includes[i]);
+  for (i = 0; i < MAX_FILTERS; ++i)
+    ADD(pc->excludes[i]);
+  ADD(pc->case_key);
+  ADD(pc->drop_cache_command);
+  ADD(pc->upload_command);
+  ADD(pc->object_store_url);
+  ADD(pc->object_store_region);
+  ADD(pc->replay_file);
+  ADD(pc->replay_dataset);
+#undef ADD
+  assert(n <= MAX_STRING_FIELDS);
+
+  /* the segments in between are copied as is, in order */
+  qsort(f, n, sizeof(string_field), by_offset);
+  return n;
+}
+
+void broadcast_config(configuration* pconfig, int root, MPI_Comm comm)
+{
+  string_field f[MAX_STRING_FIELDS];
+  const unsigned int n = string_fields(pconfig, f);
+  unsigned int header[2], len, i;
+  char *base = (char*) pconfig, *buf;
+  int rank, size, bytes, pos = 0;
+  size_t at, end;
+
+  MPI_Comm_rank(comm, &rank);
+  if (rank == root)
+    {
+      header[0] = CONFIG_VERSION;
+      header[1] = (unsigned int) sizeof(configuration);
+      MPI_Pack_size(2 + n, MPI_UNSIGNED, comm, &size);
+      MPI_Pack_size((int) sizeof(configuration), MPI_BYTE, comm, &bytes);
+      size += bytes;
+      buf = (char*) malloc(size);
+      MPI_Pack(header, 2, MPI_UNSIGNED, buf, size, &pos, comm);
+      for (i = 0, at = 0; i <= n; ++i)
+        {
+          end = (i < n) ? f[i].offset : sizeof(configuration);
+          MPI_Pack(base + at, (int)(end - at), MPI_BYTE, buf, size, &pos, comm);
+          if (i == n)
+            break;
+          len = (unsigned int) strnlen(base + end, f[i].size);
+          MPI_Pack(&len, 1, MPI_UNSIGNED, buf, size, &pos, comm);
+          MPI_Pack(base + end, (int)len, MPI_BYTE, buf, size, &pos, comm);
+          at = end + f[i].size;
+        }
+      size = pos;
+    }
+
+  MPI_Bcast(&size, 1, MPI_INT, root, comm);
+  if (rank != root)
+    buf = (char*) malloc(size);
+  MPI_Bcast(buf, size, MPI_PACKED, root, comm);
+
+  if (rank != root)
+    {
+      MPI_Unpack(buf, size, &pos, header, 2, MPI_UNSIGNED, comm);
+      assert(header[0] == CONFIG_VERSION &&
+             header[1] == (unsigned int) sizeof(configuration));
+      for (i = 0, at = 0; i <= n; ++i)
+        {
+          end = (i < n) ? f[i].offset : sizeof(configuration);
+          MPI_Unpack(buf, size, &pos, base + at, (int)(end - at), MPI_BYTE, comm);
+          if (i == n)
+            break;
+          MPI_Unpack(buf, size, &pos, &len, 1, MPI_UNSIGNED, comm);
+          assert(len <= f[i].size);
+          MPI_Unpack(buf, size, &pos, base + end, (int)len, MPI_BYTE, comm);
+          memset(base + end + len, 0, f[i].size - len);
+          at = end + f[i].size;
+        }
+    }
+  free(buf);
+}
+
 /*
  *
  * Check if the parameters have sensible values
@@ -225,47 +1057,79 @@ int validate(configuration* pconfig, const int size)
   assert(pconfig->proc_rows >= 1);
   assert(pconfig->cols > 1);
   assert(pconfig->proc_cols >= 1);
-  assert(strncmp(pconfig->scaling, "weak", 16) == 0 ||
-         strncmp(pconfig->scaling, "strong", 16) == 0);
+  assert(pconfig->scaling < SCALING_COUNT);
   assert(pconfig->rank > 1 && pconfig->rank < 5);
 
   assert(pconfig->proc_rows*pconfig->proc_cols == (unsigned)size);
 
-  if (strncmp(pconfig->scaling, "strong", 16) == 0) {
-    assert(pconfig->rows%pconfig->proc_rows == 0);
-    assert(pconfig->cols%pconfig->proc_cols == 0);
+  /* tiles can be uneven, but not empty */
+  if (pconfig->scaling == SCALING_STRONG) {
+    assert(pconfig->rows >= pconfig->proc_rows);
+    assert(pconfig->cols >= pconfig->proc_cols);
   }
 
   assert(pconfig->alignment_increment >= 1);
 
   assert(strncmp(pconfig->single_process, "posix", 16) == 0 ||
          strncmp(pconfig->single_process, "core", 16) == 0  ||
-         strncmp(pconfig->single_process, "mpi-io-uni", 16) == 0);
+         strncmp(pconfig->single_process, "mpi-io-uni", 16) == 0 ||
+         strncmp(pconfig->single_process, "direct", 16) == 0);
+  /* the split driver's member files need a backing store */
+  assert(pconfig->core_backing_store == 1 || pconfig->split == 0);
 
   assert(pconfig->restart == 0 || pconfig->restart == 1);
   assert(pconfig->split == 0 || pconfig->split == 1);
+  assert(pconfig->multi_dataset == 0 || pconfig->multi_dataset == 1);
+  assert(pconfig->append == 0 || pconfig->append == 1);
+  assert(pconfig->precreate == 0 || pconfig->precreate == 1);
+  assert(pconfig->markers == 0 || pconfig->markers == 1);
+  assert(pconfig->repetitions >= 1 && pconfig->repetitions <= MAX_REPETITIONS);
+  assert(pconfig->ci_target >= 0.0);
+  assert(pconfig->async_buffers >= 1);
+  assert(pconfig->selection_cache == 0 || pconfig->selection_cache == 1);
+  assert(pconfig->file_modes > 0 && pconfig->file_modes < (1u << FILE_MODE_COUNT));
+  assert(pconfig->nchunk_scales >= 1 && pconfig->nchunk_scales <= MAX_SWEEP);
+  assert(pconfig->nchunk_caches >= 1 && pconfig->nchunk_caches <= MAX_SWEEP);
+  assert(pconfig->nhints <= MAX_HINTS);
+  assert(pconfig->nincludes <= MAX_FILTERS && pconfig->nexcludes <= MAX_FILTERS);
   assert(pconfig->one_case >= 0);
+  /* a power of two, and a multiple of sizeof(void*) for posix_memalign */
+  assert(pconfig->buffer_alignment >= sizeof(void*) &&
+         (pconfig->buffer_alignment & (pconfig->buffer_alignment - 1)) == 0);
+  assert(pconfig->huge_pages == 0 || pconfig->huge_pages == 1);
+  assert(pconfig->read_modes > 0 && pconfig->read_modes < (1u << READ_MODE_COUNT));
+  assert(pconfig->read_shift >= -1);
+  assert(pconfig->object_store_pbuf.min_meta_perc +
+         pconfig->object_store_pbuf.min_raw_perc <= 100);
+  assert(pconfig->read_patterns > 0 &&
+         pconfig->read_patterns < (1u << READ_PATTERN_COUNT));
+  assert(pconfig->time_series_array < pconfig->arrays);
+  assert(pconfig->fspace_strategies > 0 &&
+         pconfig->fspace_strategies < (1u << FSPACE_STRATEGY_COUNT));
+  assert(pconfig->npage_sizes >= 1 && pconfig->npage_sizes <= MAX_SWEEP);
+  assert(pconfig->nthread_counts >= 1 && pconfig->nthread_counts <= MAX_SWEEP);
+  assert(pconfig->npage_buffers >= 1 && pconfig->npage_buffers <= MAX_SWEEP);
+  assert(pconfig->nmdc_configs >= 1 && pconfig->nmdc_configs <= MAX_SWEEP);
+  assert(pconfig->coll_metadata_modes > 0 && pconfig->coll_metadata_modes < 4);
+  assert(pconfig->generators > 0 && pconfig->generators < (1u << GENERATOR_COUNT));
+  assert(pconfig->datatypes > 0 && pconfig->datatypes < (1u << DATATYPE_COUNT));
+  assert(pconfig->type_conversion == 0 || pconfig->type_conversion == 1);
+  /* replay needs something to replay */
+  assert((pconfig->generators & (1u << 4)) == 0 ||
+         (pconfig->replay_file[0] != '\0' && pconfig->replay_dataset[0] != '\0'));
 
 
-  if (strncmp(pconfig->compress_type, "gzip", 16) == 0) {
-    /* check if gzip compression is available */
-    avail = H5Zfilter_avail(H5Z_FILTER_DEFLATE);
-    assert(avail > 0 );
+  assert(pconfig->ncompressions >= 1 && pconfig->ncompressions <= MAX_SWEEP);
+  assert(pconfig->aggregations > 0 &&
+         pconfig->aggregations < (1u << AGGREGATION_COUNT));
+  if (pconfig->compression.id != H5Z_FILTER_NONE) {
+    /* check if the filter (plugin) is available, for encoding */
+    avail = H5Zfilter_avail(pconfig->compression.id);
+    assert(avail > 0);
 
-    status = H5Zget_filter_info (H5Z_FILTER_DEFLATE, &filter_info);
-    assert(status >= 0);
-    assert( (filter_info & H5Z_FILTER_CONFIG_ENCODE_ENABLED) ||
-            (filter_info & H5Z_FILTER_CONFIG_DECODE_ENABLED) );
-  } else if (strncmp(pconfig->compress_type, "szip", 16) == 0) {
-    /* check if szip compression is available */
-    avail = H5Zfilter_avail(H5Z_FILTER_SZIP);
-    assert(avail > 0 );
-
-    status = H5Zget_filter_info (H5Z_FILTER_SZIP, &filter_info);
+    status = H5Zget_filter_info(pconfig->compression.id, &filter_info);
     assert(status >= 0);
-
-    assert( (filter_info & H5Z_FILTER_CONFIG_ENCODE_ENABLED) ||
-            (filter_info & H5Z_FILTER_CONFIG_DECODE_ENABLED) );
+    assert(filter_info & H5Z_FILTER_CONFIG_ENCODE_ENABLED);
   }
 
   return 0;
@@ -34,6 +34,177 @@ typedef struct duration {
     time_unit     unit;
 } duration;
 
+/* Scaling: a rows x cols tile per rank (weak), or a rows x cols array
+   split across the ranks (strong) */
+
+#define SCALING_COUNT 2
+
+enum { SCALING_WEAK, SCALING_STRONG };
+
+extern const char* scaling_names[SCALING_COUNT];
+
+/* The slowest changing dimension of the datasets, step or array */
+
+#define SLOWDIM_COUNT 2
+
+enum { SLOWDIM_STEP, SLOWDIM_ARRAY };
+
+extern const char* slowdim_names[SLOWDIM_COUNT];
+
+/* Dataset layouts */
+
+#define LAYOUT_COUNT 2
+
+enum { LAYOUT_CONTIGUOUS, LAYOUT_CHUNKED };
+
+extern const char* layout_names[LAYOUT_COUNT];
+
+/* Writing fill values (at allocation), or never */
+
+#define FILL_COUNT 2
+
+enum { FILL_ON, FILL_OFF };
+
+extern const char* fill_names[FILL_COUNT];
+
+/* File layouts across ranks: one shared file, a file per process,
+   or subfiles managed by the subfiling VFD */
+
+#define FILE_MODE_COUNT 3
+
+enum { FILE_MODE_SHARED, FILE_MODE_PER_PROCESS, FILE_MODE_SUBFILING };
+
+extern const char* file_mode_names[FILE_MODE_COUNT];
+
+/* Read phases: right after the write phase, (as much as possible)
+   without the help of the page cache, or from an object store (see
+   object_store.h) */
+
+#define READ_MODE_COUNT 3
+
+enum { READ_MODE_WARM, READ_MODE_COLD, READ_MODE_OBJECT_STORE };
+
+extern const char* read_mode_names[READ_MODE_COUNT];
+
+/* maximum number of values of a list-valued sweep parameter */
+
+#define MAX_SWEEP 8
+
+/* maximum number of (measured) repetitions of a case */
+
+#define MAX_REPETITIONS 64
+
+/* Chunk cache parameters (H5Pset_chunk_cache), the H5D_CHUNK_CACHE_*_DEFAULT
+   values leave the cache as configured on the file access property list */
+
+typedef struct chunk_cache {
+  size_t nslots;
+  size_t nbytes;
+  double w0;
+} chunk_cache;
+
+/* File space strategies (H5Pset_file_space_strategy), in the order of
+   H5F_fspace_strategy_t */
+
+#define FSPACE_STRATEGY_COUNT 4
+
+extern const char* fspace_strategy_names[FSPACE_STRATEGY_COUNT];
+
+/* Data generators (see generators.h) */
+
+#define GENERATOR_COUNT 5
+
+extern const char* generator_names[GENERATOR_COUNT];
+
+/* Element types: native double, float, and 16-bit integer, and a compound
+   particle record (see dataset.h) */
+
+#define DATATYPE_COUNT 4
+
+enum { DATATYPE_DOUBLE, DATATYPE_FLOAT, DATATYPE_INT16, DATATYPE_COMPOUND };
+
+extern const char* datatype_names[DATATYPE_COUNT];
+
+/* Tile decompositions: ranks in order, node-aware, and node-aware with an
+   aggregator per node (see aggregate.h) */
+
+#define AGGREGATION_COUNT 3
+
+enum { AGGREGATION_NONE, AGGREGATION_NODE_MAP, AGGREGATION_NODE_AGG };
+
+extern const char* aggregation_names[AGGREGATION_COUNT];
+
+/* Read patterns: the write decomposition, a single array's time series,
+   a tile-sized box across rank boundaries, random tiles, and all ranks
+   reading the same tile */
+
+#define READ_PATTERN_COUNT 5
+
+extern const char* read_pattern_names[READ_PATTERN_COUNT];
+
+/* Page buffer (H5Pset_page_buffer_size), a size of 0 means no page buffer */
+
+typedef struct page_buffer {
+  size_t       size;
+  unsigned int min_meta_perc;
+  unsigned int min_raw_perc;
+} page_buffer;
+
+/* Metadata cache (H5Pset_mdc_config), an initial size of 0 leaves the
+   library defaults */
+
+typedef struct mdc_config {
+  size_t       initial_size;
+  size_t       max_size;
+  unsigned int evictions;
+} mdc_config;
+
+/* Dataset filters (H5Pset_filter), a named preset or a filter id with its
+   client data, e.g., gzip:6, zstd:3, blosc-lz4:5, zfp-accuracy:1e-4, or
+   32017:...; H5Z_FILTER_NONE means no filter */
+
+#define MAX_CD_VALUES 12
+
+/* registered ids of the filter plugins with presets (the plugins' own
+   headers use the same names) */
+
+#ifndef H5Z_FILTER_BLOSC
+#define H5Z_FILTER_BLOSC 32001
+#endif
+#ifndef H5Z_FILTER_LZ4
+#define H5Z_FILTER_LZ4   32004
+#endif
+#ifndef H5Z_FILTER_ZFP
+#define H5Z_FILTER_ZFP   32013
+#endif
+#ifndef H5Z_FILTER_ZSTD
+#define H5Z_FILTER_ZSTD  32015
+#endif
+
+typedef struct dataset_filter {
+  char          label[32];      /* as configured */
+  H5Z_filter_t  id;
+  unsigned int  flags;
+  size_t        cd_nelmts;
+  unsigned int  cd_values[MAX_CD_VALUES];
+} dataset_filter;
+
+/* MPI-IO hints from the [mpi-hints] section, each with a list of values */
+
+#define MAX_HINTS 16
+
+typedef struct mpi_hint {
+  char         key[64];
+  unsigned int nvalues;
+  char         values[MAX_SWEEP][64];
+} mpi_hint;
+
+/* Include and exclude filters on the parameter space (see param_space.h) */
+
+#define MAX_FILTERS  16
+#define FILTER_LEN   256
+#define CASE_KEY_LEN 1024
+
 /* Configuration parameters */
 
 typedef struct
@@ -45,28 +216,111 @@ typedef struct
   unsigned long cols;
   unsigned int  proc_rows;
   unsigned int  proc_cols;
-  char          scaling[16];
+  unsigned int  scaling;        /* see scaling_names */
   unsigned int  rank;
-  char          slowest_dimension[16];
+  unsigned int  slowest_dimension;  /* see slowdim_names */
   char          libver_bound_low[16];
   char          libver_bound_high[16];
   hsize_t       alignment_increment;
   hsize_t       alignment_threshold;
   hsize_t       meta_block_size;
-  char          layout[16];
-  char          fill_values[8];
+  unsigned int  layout;         /* see layout_names */
+  unsigned int  fill_values;    /* see fill_names */
   char          single_process[16];
   char          mpi_io[16];
+  unsigned int  core_backing_store;  /* write the core driver's file on close */
   char          hdf5_file[PATH_MAX+1];
   char          csv_file[PATH_MAX+1];
+  char          step_csv_file[PATH_MAX+1];  /* per-step time series, "": none */
+  unsigned int  markers;        /* profiler regions (see instrument.h) */
+  unsigned int  warmups;        /* unreported runs of each case */
+  unsigned int  repetitions;    /* reported runs of each case (at most) */
+  unsigned int  reuse_file;     /* runs after the first rewrite the file */
+  unsigned int  reuse;          /* does the current run rewrite the file? */
+  double        ci_target;      /* stop once the 95% CIs are within this fraction of the means */
   unsigned int  restart;
   unsigned int  split;
   unsigned int  one_case;
   unsigned int  HDF5perCase;
-  char          compress_type[16];
-  unsigned int  compress_par[2];
   unsigned int  async;
+  unsigned int  async_buffers;
   duration      delay;
+  unsigned int  multi_dataset;
+  unsigned int  append;         /* grow the datasets step by step */
+  unsigned int  precreate;      /* create the datasets ahead of the writes */
+  unsigned int  selection_cache;
+  unsigned int  file_modes;     /* bit i set if file_mode_names[i] is requested */
+  unsigned int  file_mode;      /* the current file mode (index) */
+  unsigned long long subfiling_stripe_size;
+  unsigned int  subfiling_ioc_per_node;
+  /* chunk shape multipliers (rows x cols) of a rank's tile */
+  unsigned int  nchunk_scales;
+  double        chunk_scales[MAX_SWEEP][2];
+  double        chunk_scale[2];          /* the current multipliers */
+  unsigned int  nchunk_caches;
+  chunk_cache   chunk_caches[MAX_SWEEP];
+  chunk_cache   cache;                   /* the current chunk cache */
+  /* MPI-IO hints, their current combination, and what MPI-IO made of it */
+  unsigned int  nhints;
+  mpi_hint      hints[MAX_HINTS];
+  char          hints_requested[512];
+  char          hints_effective[512];
+  unsigned int  nincludes;
+  char          includes[MAX_FILTERS][FILTER_LEN];
+  unsigned int  nexcludes;
+  char          excludes[MAX_FILTERS][FILTER_LEN];
+  char          case_key[CASE_KEY_LEN];  /* the current case */
+  unsigned long long buffer_alignment;   /* of the I/O buffers [B] */
+  unsigned int  huge_pages;
+  unsigned int  read_modes;     /* bit i set if read_mode_names[i] is requested */
+  unsigned int  read_mode;      /* the current read mode (index) */
+  int           read_shift;     /* rank shift of cold reads, -1: ranks per node */
+  char          drop_cache_command[PATH_MAX+1];
+  /* reads from an object store (see object_store.h) */
+  char          upload_command[PATH_MAX+1];
+  char          object_store_url[PATH_MAX+1];
+  char          object_store_region[32];
+  page_buffer   object_store_pbuf;
+  unsigned int  read_patterns;  /* bit i set if read_pattern_names[i] is requested */
+  unsigned int  time_series_array;  /* the array read by time-series */
+  unsigned int  random_tiles;   /* reads per rank of random-tiles, 0: steps x arrays */
+  unsigned long read_seed;      /* of random-tiles */
+  /* file space management and page buffering */
+  unsigned int  fspace_strategies; /* bit i set if fspace_strategy_names[i] is requested */
+  unsigned int  fspace_strategy;   /* the current strategy (H5F_fspace_strategy_t) */
+  unsigned int  npage_sizes;
+  hsize_t       page_sizes[MAX_SWEEP];
+  hsize_t       page_size;         /* the current file space page size */
+  unsigned int  npage_buffers;
+  page_buffer   page_buffers[MAX_SWEEP];
+  page_buffer   pbuf;              /* the current page buffer */
+  /* metadata cache and collective metadata operations */
+  unsigned int  nmdc_configs;
+  mdc_config    mdc_configs[MAX_SWEEP];
+  mdc_config    mdc;                  /* the current metadata cache */
+  unsigned int  coll_metadata_modes;  /* bit 0 off, bit 1 on */
+  unsigned int  coll_metadata;        /* the current mode */
+  /* the data written */
+  unsigned int  generators;     /* bit i set if generator_names[i] is requested */
+  unsigned int  generator;      /* the current generator (index) */
+  char          replay_file[PATH_MAX+1];
+  char          replay_dataset[256];
+  /* the element type */
+  unsigned int  datatypes;      /* bit i set if datatype_names[i] is requested */
+  unsigned int  datatype;       /* the current type (index) */
+  unsigned int  type_conversion;  /* store the elements in the other byte order */
+  /* dataset filters (compression) */
+  unsigned int  ncompressions;
+  dataset_filter compressions[MAX_SWEEP];
+  dataset_filter compression;          /* the current filter */
+  unsigned int  compression_applied;  /* is it on the datasets? */
+  /* threads per rank issuing HDF5 calls (see threads.h) */
+  unsigned int  nthread_counts;
+  unsigned int  thread_counts[MAX_SWEEP];
+  unsigned int  threads;        /* the current count */
+  /* tile decomposition */
+  unsigned int  aggregations;   /* bit i set if aggregation_names[i] is requested */
+  unsigned int  aggregation;    /* the current decomposition (index) */
 } configuration;
 
 extern int handler(void* user,
@@ -74,6 +328,16 @@ extern int handler(void* user,
                    const char* name,
                    const char* value);
 
+extern unsigned int hint_combinations(const configuration* pconfig);
+
+extern MPI_Info select_hints(configuration* pconfig, unsigned int icombo);
+
+extern void check_compressions(configuration* pconfig);
+
+/* Broadcast the configuration from root (collective) */
+
+extern void broadcast_config(configuration* pconfig, int root, MPI_Comm comm);
+
 extern int validate(configuration* user, const int size);
 
 #endif
@@ -15,8 +15,178 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+/*
+ *
+ * Balanced block distribution of n items over p parts
+ *
+ */
+
+static unsigned long block_size(unsigned long n, unsigned long p, unsigned long i)
+{
+  return n/p + ((i < n%p) ? 1 : 0);
+}
+
+static unsigned long block_start(unsigned long n, unsigned long p, unsigned long i)
+{
+  return i*(n/p) + ((i < n%p) ? i : n%p);
+}
+
+void get_partition(const configuration* config, int proc_row, int proc_col,
+                   partition* pp)
+{
+  if (config->scaling == SCALING_STRONG)
+    {
+      pp->rows = block_size(config->rows, config->proc_rows, proc_row);
+      pp->cols = block_size(config->cols, config->proc_cols, proc_col);
+      pp->row0 = block_start(config->rows, config->proc_rows, proc_row);
+      pp->col0 = block_start(config->cols, config->proc_cols, proc_col);
+    }
+  else
+    {
+      pp->rows = config->rows;
+      pp->cols = config->cols;
+      pp->row0 = (unsigned long)proc_row*config->rows;
+      pp->col0 = (unsigned long)proc_col*config->cols;
+    }
+}
+
+/*
+ *
+ * The element types in memory and in the file
+ *
+ */
+
+static hid_t create_mem_type(unsigned int datatype)
+{
+  hid_t result;
+
+  switch (datatype)
+    {
+    case DATATYPE_FLOAT:
+      assert((result = H5Tcopy(H5T_NATIVE_FLOAT)) >= 0);
+      break;
+    case DATATYPE_INT16:
+      assert((result = H5Tcopy(H5T_NATIVE_SHORT)) >= 0);
+      break;
+    case DATATYPE_COMPOUND:
+      assert((result = H5Tcreate(H5T_COMPOUND, sizeof(particle))) >= 0);
+      assert(H5Tinsert(result, "x", HOFFSET(particle, x), H5T_NATIVE_DOUBLE) >= 0);
+      assert(H5Tinsert(result, "y", HOFFSET(particle, y), H5T_NATIVE_DOUBLE) >= 0);
+      assert(H5Tinsert(result, "z", HOFFSET(particle, z), H5T_NATIVE_DOUBLE) >= 0);
+      assert(H5Tinsert(result, "mass", HOFFSET(particle, mass), H5T_NATIVE_FLOAT) >= 0);
+      assert(H5Tinsert(result, "id", HOFFSET(particle, id), H5T_NATIVE_INT) >= 0);
+      break;
+    default:
+      assert((result = H5Tcopy(H5T_NATIVE_DOUBLE)) >= 0);
+      break;
+    }
+  return result;
+}
+
+size_t datatype_size(unsigned int datatype)
+{
+  switch (datatype)
+    {
+    case DATATYPE_FLOAT:    return sizeof(float);
+    case DATATYPE_INT16:    return sizeof(short);
+    case DATATYPE_COMPOUND: return sizeof(particle);
+    default:                return sizeof(double);
+    }
+}
+
+/* The same type in the other byte order (compounds member by member, packed) */
+
+static hid_t swap_order(hid_t type)
+{
+  hid_t result, member;
+  size_t offset = 0;
+  char* name;
+  int i, n;
+
+  if (H5Tget_class(type) != H5T_COMPOUND)
+    {
+      assert((result = H5Tcopy(type)) >= 0);
+      assert(H5Tset_order(result, (H5Tget_order(type) == H5T_ORDER_LE) ?
+                          H5T_ORDER_BE : H5T_ORDER_LE) >= 0);
+      return result;
+    }
+
+  assert((n = H5Tget_nmembers(type)) > 0);
+  assert((result = H5Tcreate(H5T_COMPOUND, H5Tget_size(type))) >= 0);
+  for (i = 0; i < n; ++i)
+    {
+      hid_t mtype;
+      assert((mtype = H5Tget_member_type(type, (unsigned)i)) >= 0);
+      member = swap_order(mtype);
+      assert((name = H5Tget_member_name(type, (unsigned)i)) != NULL);
+      assert(H5Tinsert(result, name, offset, member) >= 0);
+      offset += H5Tget_size(member);
+      H5free_memory(name);
+      assert(H5Tclose(member) >= 0);
+      assert(H5Tclose(mtype) >= 0);
+    }
+  assert(H5Tpack(result) >= 0);
+  return result;
+}
+
+void create_plan(const configuration* config, int proc_row, int proc_col,
+                 plan* pp)
+{
+  const unsigned int strong_scaling_flg = (config->scaling == SCALING_STRONG);
+  size_t words;
+
+  get_partition(config, proc_row, proc_col, &pp->tile);
+  pp->total_rows = strong_scaling_flg ?
+    config->rows : config->proc_rows*config->rows;
+  pp->total_cols = strong_scaling_flg ?
+    config->cols : config->proc_cols*config->cols;
+  pp->step_first_flg = (config->slowest_dimension == SLOWDIM_STEP);
+  pp->chunked_flg = (config->layout == LAYOUT_CHUNKED);
+
+  pp->mem_type = create_mem_type(config->datatype);
+  if (config->type_conversion)
+    pp->file_type = swap_order(pp->mem_type);
+  else
+    assert((pp->file_type = H5Tcopy(pp->mem_type)) >= 0);
+  pp->elem_size = H5Tget_size(pp->mem_type);
+  words = (pp->elem_size + sizeof(double) - 1)/sizeof(double);
+  pp->tile_words = pp->tile.rows*pp->tile.cols*words;
+}
+
+void close_plan(plan* pp)
+{
+  assert(H5Tclose(pp->file_type) >= 0);
+  assert(H5Tclose(pp->mem_type) >= 0);
+}
+
+/*
+ *
+ * Is the current dataset filter applied? Parallel compression only works
+ * with collective I/O.
+ *
+ */
+
+unsigned int compression_applies(const configuration* config,
+                                 unsigned int coll_mpi_io_flg)
+{
+  /* H5Z-ZFP compresses floating-point (and 32/64-bit integer)
+     elements only */
+  const unsigned int zfp_type_flg =
+    (config->datatype == DATATYPE_DOUBLE || config->datatype == DATATYPE_FLOAT);
+  /* szip's can_apply rejects elements other than up to 32 or 64 bits */
+  const unsigned int szip_type_flg = (config->datatype != DATATYPE_COMPOUND);
+
+  return config->compression.id != H5Z_FILTER_NONE &&
+    (config->compression.id != H5Z_FILTER_ZFP || zfp_type_flg) &&
+    (config->compression.id != H5Z_FILTER_SZIP || szip_type_flg) &&
+    config->layout == LAYOUT_CHUNKED &&
+    (config->proc_rows*config->proc_cols == 1 || coll_mpi_io_flg == 1);
+}
+
 /*
  *
  * Initialize the dataset creation property list.
@@ -28,33 +198,45 @@ hid_t create_dcpl(const configuration* config, unsigned int coll_mpi_io_flg)
   hid_t result;
   unsigned int strong_scaling_flg, step_first_flg, chunked_flg;
   unsigned long total_rows, total_cols, my_rows, my_cols;
-  hsize_t cdims[H5S_MAX_RANK];
+  hsize_t cdims[H5S_MAX_RANK], chunk_rows, chunk_cols;
+  partition part;
 
   assert((result = H5Pcreate(H5P_DATASET_CREATE)) >= 0);
 
-  strong_scaling_flg = (strncmp(config->scaling, "strong", 16) == 0);
+  strong_scaling_flg = (config->scaling == SCALING_STRONG);
   total_rows = strong_scaling_flg ?
     config->rows : config->proc_rows*config->rows;
   total_cols = strong_scaling_flg ?
     config->cols : config->proc_cols*config->cols;
-  my_rows = strong_scaling_flg ? config->rows/config->proc_rows : config->rows;
-  my_cols = strong_scaling_flg ? config->cols/config->proc_cols : config->cols;
+  /* the chunk shape is the same for all (uneven) tiles, the first is the
+     largest */
+  get_partition(config, 0, 0, &part);
+  my_rows = part.rows;
+  my_cols = part.cols;
 
-  step_first_flg = (strncmp(config->slowest_dimension, "step", 16) == 0);
-  chunked_flg = (strncmp(config->layout, "chunked", 16) == 0);
+  step_first_flg = (config->slowest_dimension == SLOWDIM_STEP);
+  chunked_flg = (config->layout == LAYOUT_CHUNKED);
 
   if (chunked_flg)
     {
+      /* a multiple (or fraction) of a rank's tile, within the dataset */
+      chunk_rows = (hsize_t)(config->chunk_scale[0]*my_rows + 0.5);
+      chunk_cols = (hsize_t)(config->chunk_scale[1]*my_cols + 0.5);
+      chunk_rows = (chunk_rows < 1) ? 1 :
+        ((chunk_rows > total_rows) ? total_rows : chunk_rows);
+      chunk_cols = (chunk_cols < 1) ? 1 :
+        ((chunk_cols > total_cols) ? total_cols : chunk_cols);
+
       switch (config->rank)
         {
         case 2:
-          cdims[0] = (hsize_t)my_rows;
-          cdims[1] = (hsize_t)my_cols;
+          cdims[0] = chunk_rows;
+          cdims[1] = chunk_cols;
           break;
         case 3:
           cdims[0] = 1;
-          cdims[1] = (hsize_t)my_rows;
-          cdims[2] = (hsize_t)my_cols;
+          cdims[1] = chunk_rows;
+          cdims[2] = chunk_cols;
           break;
         case 4:
           if (step_first_flg)
@@ -67,8 +249,8 @@ hid_t create_dcpl(const configuration* config, unsigned int coll_mpi_io_flg)
               cdims[0] = (hsize_t)config->arrays;
               cdims[1] = 1;
             }
-          cdims[2] = (hsize_t)my_rows;
-          cdims[3] = (hsize_t)my_cols;
+          cdims[2] = chunk_rows;
+          cdims[3] = chunk_cols;
           break;
         default:
           break;
@@ -76,22 +258,26 @@ hid_t create_dcpl(const configuration* config, unsigned int coll_mpi_io_flg)
 
       assert(H5Pset_chunk(result, config->rank, cdims) >= 0);
 
-      /* apply compression:
-       * parallel compression only works for collective
-       */
-      if( config->proc_rows*config->proc_cols == 1  ||  coll_mpi_io_flg == 1) {
-        if (strncmp(config->compress_type, "gzip", 16) == 0) {
-          assert( H5Pset_deflate(result, config->compress_par[0]) >= 0);
-        } else if (strncmp(config->compress_type, "szip", 16) == 0) {
-          assert( H5Pset_szip(result, config->compress_par[0], config->compress_par[1]) >= 0);
+      /* apply compression (see compression_applies) */
+      if (compression_applies(config, coll_mpi_io_flg))
+        {
+          if (config->compression.id == H5Z_FILTER_SZIP &&
+              config->compression.cd_nelmts == 2)
+            /* adds the option bits which aren't public */
+            assert(H5Pset_szip(result, config->compression.cd_values[0],
+                               config->compression.cd_values[1]) >= 0);
+          else
+            assert(H5Pset_filter(result, config->compression.id,
+                                 config->compression.flags,
+                                 config->compression.cd_nelmts,
+                                 config->compression.cd_values) >= 0);
         }
-      }
 
     }
   else
     assert(H5Pset_layout(result, H5D_CONTIGUOUS) >= 0);
 
-  if (strncmp(config->fill_values, "false", 8) == 0)
+  if (config->fill_values == FILL_OFF)
     assert(H5Pset_fill_time(result, H5D_FILL_TIME_NEVER) >= 0);
   else
     assert(H5Pset_fill_time(result, H5D_FILL_TIME_ALLOC) >= 0);
@@ -101,27 +287,23 @@ hid_t create_dcpl(const configuration* config, unsigned int coll_mpi_io_flg)
 
 /*
  *
- * Create the dataset's file space
+ * The dataset's (final) extent and maximum extent
  *
  */
 
-static hid_t create_fspace(const configuration* config)
+static void get_dims(const configuration* config, hsize_t dims[], hsize_t max_dims[])
 {
-  hid_t result = -1;
   unsigned int strong_scaling_flg, step_first_flg, chunked_flg;
-  unsigned long total_rows, total_cols, my_rows, my_cols;
-  hsize_t dims[H5S_MAX_RANK], max_dims[H5S_MAX_RANK];
+  unsigned long total_rows, total_cols;
 
-  strong_scaling_flg = (strncmp(config->scaling, "strong", 16) == 0);
+  strong_scaling_flg = (config->scaling == SCALING_STRONG);
   total_rows = strong_scaling_flg ?
     config->rows : config->proc_rows*config->rows;
   total_cols = strong_scaling_flg ?
     config->cols : config->proc_cols*config->cols;
-  my_rows = strong_scaling_flg ? config->rows/config->proc_rows : config->rows;
-  my_cols = strong_scaling_flg ? config->cols/config->proc_cols : config->cols;
 
-  step_first_flg = (strncmp(config->slowest_dimension, "step", 16) == 0);
-  chunked_flg = (strncmp(config->layout, "chunked", 16) == 0);
+  step_first_flg = (config->slowest_dimension == SLOWDIM_STEP);
+  chunked_flg = (config->layout == LAYOUT_CHUNKED);
 
   switch (config->rank)
     {
@@ -158,6 +340,32 @@ static hid_t create_fspace(const configuration* config)
     default:
       break;
     }
+}
+
+/* The (unlimited) step dimension of an appended dataset */
+
+static int step_dim(const configuration* config)
+{
+  const unsigned int step_first_flg =
+    (config->slowest_dimension == SLOWDIM_STEP);
+  return (config->rank == 4 && !step_first_flg) ? 1 : 0;
+}
+
+/*
+ *
+ * Create the dataset's file space. Appended datasets start out without
+ * steps, unless the final extent is requested (for the selection cache).
+ *
+ */
+
+static hid_t create_fspace(const configuration* config, unsigned int final_flg)
+{
+  hid_t result = -1;
+  hsize_t dims[H5S_MAX_RANK], max_dims[H5S_MAX_RANK];
+
+  get_dims(config, dims, max_dims);
+  if (config->append && !final_flg)
+    dims[step_dim(config)] = 0;
 
   assert((result = H5Screate_simple(config->rank, dims, max_dims)) >= 0);
 
@@ -166,87 +374,153 @@ static hid_t create_fspace(const configuration* config)
 
 /*
  *
- * Create an anonymous dataset for the current configuration
- * (this then needs to be linked into the file)
+ * Grow an appended dataset to hold step (which is timed separately)
  *
  */
 
-hid_t create_dataset(const configuration* config, hid_t file, const char* name,
-                     hid_t lcpl, hid_t dapl, unsigned int coll_mpi_io_flg, time_step *ts)
+void extend_dataset(const configuration* config, hid_t dset,
+                    const unsigned int step, time_step* ts, metrics* pm)
 {
-  hid_t result, fspace, dcpl;
-  assert((dcpl = create_dcpl(config, coll_mpi_io_flg)) >= 0);
-  assert((fspace = create_fspace(config)) >= 0);
+  hsize_t dims[H5S_MAX_RANK], max_dims[H5S_MAX_RANK];
+  double t;
+
+  get_dims(config, dims, max_dims);
+  dims[step_dim(config)] = (hsize_t)step + 1;
+
+  t = -MPI_Wtime();
+#if H5_VERSION_GE(1,14,0)
+  if (ts != NULL)
+    assert(H5Dset_extent_async(dset, dims, ts->es_meta_create) >= 0);
+  else
+#endif
+    assert(H5Dset_extent(dset, dims) >= 0);
+  t += MPI_Wtime();
+  hist_add(&pm->extend, t);
+}
+
+/*
+ *
+ * Build the creation properties shared by the datasets of a case
+ *
+ */
+
+void create_creation_props(const configuration* config, const plan* pp,
+                           unsigned int coll_mpi_io_flg, creation_props* pcp)
+{
+  pcp->type = pp->file_type;
+  assert((pcp->dcpl = create_dcpl(config, coll_mpi_io_flg)) >= 0);
+  assert((pcp->fspace = create_fspace(config, 0)) >= 0);
+}
+
+void close_creation_props(creation_props* pcp)
+{
+  assert(H5Sclose(pcp->fspace) >= 0);
+  assert(H5Pclose(pcp->dcpl) >= 0);
+  pcp->dcpl = pcp->fspace = H5I_INVALID_HID;
+}
+
+/*
+ *
+ * Create a dataset for the current configuration
+ *
+ */
+
+hid_t create_dataset(hid_t file, const char* name, hid_t lcpl, hid_t dapl,
+                     const creation_props* pcp, time_step *ts)
+{
+  hid_t result;
 
 #if H5_VERSION_GE(1,14,0)
   if(ts != NULL) {
-    assert((result = H5Dcreate_async(file, name, H5T_NATIVE_DOUBLE, fspace,
-                                     lcpl, dcpl, dapl, ts->es_meta_create)) >= 0);
+    assert((result = H5Dcreate_async(file, name, pcp->type, pcp->fspace,
+                                     lcpl, pcp->dcpl, dapl, ts->es_meta_create)) >= 0);
   } else
 #endif
-    assert((result = H5Dcreate(file, name, H5T_NATIVE_DOUBLE, fspace,
-                               lcpl, dcpl, dapl)) >= 0);
+    assert((result = H5Dcreate(file, name, pcp->type, pcp->fspace,
+                               lcpl, pcp->dcpl, dapl)) >= 0);
 
-  assert(H5Sclose(fspace) >= 0);
-  assert(H5Pclose(dcpl) >= 0);
   return result;
 }
 
+/*
+ *
+ * The dataset holding a (step, array)
+ *
+ */
+
+void dataset_path(const configuration* config, unsigned int step,
+                  unsigned int array, char* path)
+{
+  const unsigned int step_first_flg =
+    (config->slowest_dimension == SLOWDIM_STEP);
+
+  switch (config->rank)
+    {
+    case 4:
+      strcpy(path, "dataset");
+      break;
+    case 3:
+      if (step_first_flg)
+        sprintf(path, "step=%d", step);
+      else
+        sprintf(path, "array=%d", array);
+      break;
+    default:
+      sprintf(path, (step_first_flg ?
+                     "step=%d/array=%d" : "array=%d/step=%d"),
+              (step_first_flg ? step : array),
+              (step_first_flg ? array : step));
+      break;
+    }
+}
 
 /*
  *
- * Create an in-file dataspace selection depending on the step and variable
+ * Select a region of the 2D array of a (step, variable)
  *
  */
 
-int create_selection(const configuration* config,
-                     hid_t fspace,
-                     const int proc_row,
-                     const int proc_col,
-                     const unsigned int step,
-                     const unsigned int array)
+void select_region(const configuration* config,
+                   hid_t fspace,
+                   const unsigned int step,
+                   const unsigned int array,
+                   const partition* region)
 {
-  hid_t result = 0;
-  unsigned int strong_scaling_flg, step_first_flg;
-  unsigned long my_rows, my_cols;
+  unsigned int step_first_flg;
   hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK], block[H5S_MAX_RANK];
 
-  strong_scaling_flg = (strncmp(config->scaling, "strong", 16) == 0);
-  my_rows = strong_scaling_flg ? config->rows/config->proc_rows : config->rows;
-  my_cols = strong_scaling_flg ? config->cols/config->proc_cols : config->cols;
-
-  step_first_flg = (strncmp(config->slowest_dimension, "step", 16) == 0);
+  step_first_flg = (config->slowest_dimension == SLOWDIM_STEP);
 
   switch (config->rank)
     {
     case 2:
-      start[0] = (hsize_t)proc_row*my_rows;
-      start[1] = (hsize_t)proc_col*my_cols;
+      start[0] = (hsize_t)region->row0;
+      start[1] = (hsize_t)region->col0;
       count[0] = count[1] = 1;
-      block[0] = (hsize_t)my_rows;
-      block[1] = (hsize_t)my_cols;
+      block[0] = (hsize_t)region->rows;
+      block[1] = (hsize_t)region->cols;
       break;
     case 3:
       start[0] = (hsize_t)
         (step_first_flg ? array : step);
-      start[1] = (hsize_t)proc_row*my_rows;
-      start[2] = (hsize_t)proc_col*my_cols;
+      start[1] = (hsize_t)region->row0;
+      start[2] = (hsize_t)region->col0;
       count[0] = count[1] = count[2] = 1;
       block[0] = 1;
-      block[1] = (hsize_t)my_rows;
-      block[2] = (hsize_t)my_cols;
+      block[1] = (hsize_t)region->rows;
+      block[2] = (hsize_t)region->cols;
       break;
     case 4:
       start[0] = (hsize_t)
         (step_first_flg ? step : array);
       start[1] = (hsize_t)
         (step_first_flg ? array : step);
-      start[2] = (hsize_t)proc_row*my_rows;
-      start[3] = (hsize_t)proc_col*my_cols;
+      start[2] = (hsize_t)region->row0;
+      start[3] = (hsize_t)region->col0;
       count[0] = count[1] = count[2] = count[3] = 1;
       block[0] = block[1] = 1;
-      block[2] = (hsize_t)my_rows;
-      block[3] = (hsize_t)my_cols;
+      block[2] = (hsize_t)region->rows;
+      block[3] = (hsize_t)region->cols;
       break;
     default:
       break;
@@ -255,24 +529,231 @@ int create_selection(const configuration* config,
   assert(H5Sselect_none(fspace) >= 0);
   assert(H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, block)
          >= 0);
+}
+
+/*
+ *
+ * Create the selection and account for it in the create time and histogram
+ *
+ */
+
+void timed_selection(const configuration* config,
+                     hid_t fspace,
+                     const partition* tile,
+                     const unsigned int step,
+                     const unsigned int array,
+                     double* create_time,
+                     metrics* pm)
+{
+  double t = -MPI_Wtime();
+  select_region(config, fspace, step, array, tile);
+  t += MPI_Wtime();
+  *create_time += t;
+  hist_add(&pm->select, t);
+}
+
+/*
+ *
+ * Build the selection templates for the current case
+ *
+ */
+
+void create_selection_cache(const configuration* config,
+                            const partition* tile,
+                            selection_cache* sc)
+{
+  unsigned int i;
+
+  sc->count = 0;
+  sc->fspace = NULL;
+  if (config->selection_cache == 0)
+    return;
+
+  sc->count = config->multi_dataset ? config->arrays : 1;
+  sc->step_first_flg = (config->slowest_dimension == SLOWDIM_STEP);
+  sc->fspace = (hid_t*) malloc(sc->count*sizeof(hid_t));
+  assert((sc->fspace[0] = create_fspace(config, 1)) >= 0);
+  select_region(config, sc->fspace[0], 0, 0, tile);
+  for (i = 1; i < sc->count; ++i)
+    assert((sc->fspace[i] = H5Scopy(sc->fspace[0])) >= 0);
+}
+
+/*
+ *
+ * Get the file space of the current tile with its selection, either from
+ * the dataset or from the cache
+ *
+ */
+
+hid_t select_tile(const configuration* config,
+                  selection_cache* sc,
+                  hid_t dset,
+                  const partition* tile,
+                  const unsigned int step,
+                  const unsigned int array,
+                  double* create_time,
+                  metrics* pm)
+{
+  hid_t result;
+  hssize_t offset[H5S_MAX_RANK] = { 0 };
+  double t;
+
+  if (sc->count == 0)
+    {
+      assert((result = H5Dget_space(dset)) >= 0);
+      timed_selection(config, result, tile, step, array, create_time, pm);
+      return result;
+    }
+
+  t = -MPI_Wtime();
+  result = sc->fspace[(sc->count > 1) ? array : 0];
+  switch (config->rank)
+    {
+    case 3:
+      offset[0] = (hssize_t)(sc->step_first_flg ? array : step);
+      break;
+    case 4:
+      offset[0] = (hssize_t)(sc->step_first_flg ? step : array);
+      offset[1] = (hssize_t)(sc->step_first_flg ? array : step);
+      break;
+    default:
+      break;
+    }
+  assert(H5Soffset_simple(result, offset) >= 0);
+  t += MPI_Wtime();
+  *create_time += t;
+  hist_add(&pm->select, t);
   return result;
 }
 
-void init_write_buffer(double wbuf[], const size_t* my_rows, const size_t* my_cols, size_t d[], size_t o[])
+/* Close a file space obtained from select_tile unless it's cached */
+
+void release_tile(const selection_cache* sc, hid_t fspace)
 {
-  size_t i, j;
-  for (i = 0; i < *my_rows; ++i)
-    for (j = 0; j < *my_cols; ++j)
-      wbuf[i*(*my_cols) + j] =
-        (double) (((o[0]*d[1] + o[1])*d[2] + o[2] + i)*d[3] + o[3] + j);
+  if (sc->count == 0)
+    assert(H5Sclose(fspace) >= 0);
 }
 
-void verify_read_buffer(double* rbuf, const size_t* my_rows, const size_t* my_cols, size_t d[], size_t o[])
+void close_selection_cache(selection_cache* sc)
 {
+  unsigned int i;
+
+  for (i = 0; i < sc->count; ++i)
+    assert(H5Sclose(sc->fspace[i]) >= 0);
+  free(sc->fspace);
+  sc->count = 0;
+  sc->fspace = NULL;
+}
+
+#if H5_VERSION_GE(1,14,0)
+/*
+ *
+ * Create the event sets for count in-flight time steps
+ *
+ */
+
+time_step* create_event_sets(unsigned int count)
+{
+  time_step* result = (time_step*) calloc(count, sizeof(time_step));
+  unsigned int i;
+
+  for (i = 0; i < count; ++i)
+    {
+      assert((result[i].es_meta_create = H5EScreate()) >= 0);
+      assert((result[i].es_meta_open = H5EScreate()) >= 0);
+      assert((result[i].es_meta_close = H5EScreate()) >= 0);
+      assert((result[i].es_data = H5EScreate()) >= 0);
+    }
+  return result;
+}
+
+/* Wait for all operations in an event set, and return the time it took */
+
+double drain_event_set(hid_t es)
+{
+  size_t  num_in_progress;
+  hbool_t op_failed;
+  double  result = -MPI_Wtime();
+
+  assert(H5ESwait(es, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed) >= 0);
+  assert(!op_failed);
+  result += MPI_Wtime();
+  return result;
+}
+
+void drain_metadata_event_sets(time_step* ts, metrics* pm)
+{
+  pm->drain_create += drain_event_set(ts->es_meta_create);
+  pm->drain_open += drain_event_set(ts->es_meta_open);
+  pm->drain_close += drain_event_set(ts->es_meta_close);
+}
+
+void close_event_sets(time_step* ts, unsigned int count)
+{
+  unsigned int i;
+
+  for (i = 0; i < count; ++i)
+    {
+      assert(H5ESclose(ts[i].es_meta_create) >= 0);
+      assert(H5ESclose(ts[i].es_meta_open) >= 0);
+      assert(H5ESclose(ts[i].es_meta_close) >= 0);
+      assert(H5ESclose(ts[i].es_data) >= 0);
+    }
+  free(ts);
+}
+#endif
+
+/*
+ *
+ * Data kernels
+ *
+ * The value at the 4D index [o0, o1, o2 + i, o3 + j] is its C-order
+ * position, i.e., every row is a base offset plus j. The inner loops are
+ * unit-stride and branch-free, so that the compiler can vectorize them,
+ * and the rows are shared among OpenMP threads in builds with OpenMP.
+ * The time spent here is recorded, and excluded from the phase timings.
+ *
+ */
+
+void init_write_buffer(double wbuf[], const size_t* my_rows, const size_t* my_cols,
+                       size_t d[], size_t o[], metrics* pm)
+{
+  const size_t rows = *my_rows, cols = *my_cols;
+  const size_t base = ((o[0]*d[1] + o[1])*d[2] + o[2])*d[3] + o[3];
   size_t i, j;
-  for (i = 0; i < *my_rows; ++i)
-    for (j = 0; j < *my_cols; ++j)
-      assert(fabs(rbuf[i*(*my_cols) + j] -
-                  (double) (((o[0]*d[1] + o[1])*d[2] + o[2] + i)*d[3] + o[3] + j))
-             < 1.e-12);
+
+  pm->kernel -= MPI_Wtime();
+#ifdef _OPENMP
+#pragma omp parallel for private(j) if(rows*cols > KERNEL_OMP_MIN)
+#endif
+  for (i = 0; i < rows; ++i)
+    {
+      double* row = wbuf + i*cols;
+      const double b = (double)(base + i*d[3]);
+      for (j = 0; j < cols; ++j)
+        row[j] = b + (double)j;
+    }
+  pm->kernel += MPI_Wtime();
+}
+
+void verify_read_buffer(const double* rbuf, const size_t* my_rows, const size_t* my_cols,
+                        size_t d[], size_t o[], metrics* pm)
+{
+  const size_t rows = *my_rows, cols = *my_cols;
+  const size_t base = ((o[0]*d[1] + o[1])*d[2] + o[2])*d[3] + o[3];
+  size_t i, j, errors = 0;
+
+  pm->kernel -= MPI_Wtime();
+#ifdef _OPENMP
+#pragma omp parallel for private(j) reduction(+:errors) if(rows*cols > KERNEL_OMP_MIN)
+#endif
+  for (i = 0; i < rows; ++i)
+    {
+      const double* row = rbuf + i*cols;
+      const double b = (double)(base + i*d[3]);
+      for (j = 0; j < cols; ++j)
+        errors += (fabs(row[j] - (b + (double)j)) >= 1.e-12);
+    }
+  pm->kernel += MPI_Wtime();
+  assert(errors == 0);
 }
@@ -15,46 +15,194 @@
 #define DATASET_H
 
 #include "configuration.h"
+#include "metrics.h"
 
 #include "hdf5.h"
 
+/*
+ * A rank's tile of the global 2D array. With strong scaling, the rows
+ * (columns) are distributed in balanced blocks, i.e., the first
+ * rows % proc_rows tile rows get one extra row (and likewise for the
+ * columns). With weak scaling, all tiles are rows x cols.
+ */
+
+typedef struct
+{
+  unsigned long rows;
+  unsigned long cols;
+  unsigned long row0;  /* the tile's origin */
+  unsigned long col0;
+} partition;
+
+extern void get_partition(const configuration* config, int proc_row,
+                          int proc_col, partition* pp);
+
+/* The compound element type, a particle record */
+
+typedef struct
+{
+  double x, y, z;
+  float  mass;
+  int    id;
+} particle;
+
+/*
+ * The per-case plan of the write and read engines: what the loops need to
+ * know about a case, worked out once
+ */
+
+typedef struct
+{
+  partition     tile;            /* the rank's tile */
+  unsigned long total_rows;      /* the global 2D array */
+  unsigned long total_cols;
+  unsigned int  step_first_flg;  /* the step index precedes the array index */
+  unsigned int  chunked_flg;
+  hid_t         mem_type;        /* of the elements in memory */
+  hid_t         file_type;       /* ... and in the file (with type-conversion,
+                                    in the other byte order) */
+  size_t        elem_size;       /* of mem_type [B] */
+  size_t        tile_words;      /* doubles of room for a tile, as generated
+                                    (doubles) or as transferred (elements) */
+} plan;
+
+extern void create_plan(const configuration* config, int proc_row,
+                        int proc_col, plan* pp);
+
+extern void close_plan(plan* pp);
+
+/* The size of an element of a datatype (index into datatype_names) [B] */
+
+extern size_t datatype_size(unsigned int datatype);
+
 typedef struct time_step time_step;
 
+/* Event sets for the asynchronous operations of a time step */
+
 struct time_step {
-    hid_t              es_meta_create;
-    hid_t              es_meta_close;
-    hid_t              es_data;
-    hid_t              es_meta_data;
+    hid_t              es_meta_create; /* dataset (and intermediate group) creation */
+    hid_t              es_meta_open;   /* dataset open */
+    hid_t              es_meta_close;  /* dataset close */
+    hid_t              es_data;        /* raw data transfers */
 };
 
+extern unsigned int compression_applies(const configuration* config,
+                                        unsigned int coll_mpi_io_flg);
+
 extern hid_t create_dcpl(const configuration* config, unsigned int coll_mpi_io_flg);
 
-extern hid_t create_dataset(const configuration* config,
-                            hid_t file,
+/*
+ * The dataset creation property list and file space of a case. They are
+ * the same for all datasets, and built once per case, not per dataset.
+ */
+
+typedef struct
+{
+  hid_t dcpl;
+  hid_t fspace;   /* the initial extent */
+  hid_t type;     /* the file type, owned by the plan */
+} creation_props;
+
+extern void create_creation_props(const configuration* config,
+                                  const plan* pp,
+                                  unsigned int coll_mpi_io_flg,
+                                  creation_props* pcp);
+
+extern void close_creation_props(creation_props* pcp);
+
+extern hid_t create_dataset(hid_t file,
                             const char* name,
                             hid_t lcpl,
                             hid_t dapl,
-                            unsigned int coll_mpi_io_flg,
+                            const creation_props* pcp,
                             time_step *ts);
 
-extern int create_selection(const configuration* config,
+/* The path of the dataset holding a (step, array) */
+
+extern void dataset_path(const configuration* config, unsigned int step,
+                         unsigned int array, char* path);
+
+/* With append mode, datasets are created without steps and grown with
+   H5Dset_extent before each step's writes */
+
+extern void extend_dataset(const configuration* config, hid_t dset,
+                           const unsigned int step, time_step* ts,
+                           metrics* pm);
+
+/* Select a region (not necessarily a rank's tile) of a (step, array) */
+
+extern void select_region(const configuration* config,
+                          hid_t fspace,
+                          const unsigned int step,
+                          const unsigned int array,
+                          const partition* region);
+
+extern void timed_selection(const configuration* config,
                             hid_t fspace,
-                            const int proc_row,
-                            const int proc_col,
+                            const partition* tile,
                             const unsigned int step,
-                            const unsigned int array);
+                            const unsigned int array,
+                            double* create_time,
+                            metrics* pm);
+
+/*
+ * Per-rank file space selections built once per case. The selection of
+ * (step, array) = (0, 0) is moved to other (step, array) pairs by setting
+ * the dataspace offset. With multi-dataset I/O, each array of a step needs
+ * its own copy. The templates have the final extent, i.e., they also
+ * cover the steps an appended dataset doesn't have yet.
+ */
+
+typedef struct
+{
+  unsigned int count;          /* number of templates, 0 if caching is disabled */
+  hid_t*       fspace;         /* the templates */
+  unsigned int step_first_flg; /* the step index precedes the array index */
+} selection_cache;
+
+extern void create_selection_cache(const configuration* config,
+                                   const partition* tile,
+                                   selection_cache* sc);
+
+extern hid_t select_tile(const configuration* config,
+                         selection_cache* sc,
+                         hid_t dset,
+                         const partition* tile,
+                         const unsigned int step,
+                         const unsigned int array,
+                         double* create_time,
+                         metrics* pm);
+
+extern void release_tile(const selection_cache* sc, hid_t fspace);
+
+extern void close_selection_cache(selection_cache* sc);
+
+/* the data kernels don't bother spawning OpenMP threads for smaller tiles */
+#define KERNEL_OMP_MIN 65536
 
 extern void init_write_buffer(double wbuf[],
                               const size_t* my_rows,
                               const size_t* my_cols,
                               size_t d[],
-                              size_t o[]);
+                              size_t o[],
+                              metrics* pm);
 
-extern void verify_read_buffer(double* rbuf,
+extern void verify_read_buffer(const double* rbuf,
                                const size_t* my_rows,
                                const size_t* my_cols,
                                size_t d[],
-                               size_t o[]);
+                               size_t o[],
+                               metrics* pm);
+
+#if H5_VERSION_GE(1,14,0)
+extern time_step* create_event_sets(unsigned int count);
+
+extern double drain_event_set(hid_t es);
+
+extern void drain_metadata_event_sets(time_step* ts, metrics* pm);
+
+extern void close_event_sets(time_step* ts, unsigned int count);
+#endif
 
 extern void async_sleep(hid_t file_id, 
                         hid_t fapl, 
@@ -0,0 +1,233 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "generators.h"
+#include "dataset.h"
+
+#include "hdf5.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* amplitude of the noise added by the noisy generator */
+#define NOISE 1.0e-3
+
+/* SplitMix64, a counter-based generator, i.e., element k of a stream can be
+   computed independently (and in parallel) */
+
+uint64_t mix64(uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/* uniform in [0,1) */
+static double uniform(uint64_t seed, uint64_t k)
+{
+  return (double)(mix64(seed ^ mix64(k)) >> 11) * (1.0/9007199254740992.0);
+}
+
+/* a stream per rank, step, and array */
+static uint64_t stream(const generator* pg, unsigned int istep, unsigned int iarray)
+{
+  return mix64(((uint64_t)pg->rank << 42) ^ ((uint64_t)istep << 21) ^ iarray);
+}
+
+/*
+ *
+ * Read the dataset to replay on rank 0, and broadcast it
+ *
+ */
+
+static void load_replay(const configuration* pconfig, int rank, generator* pg)
+{
+  unsigned long long n = 0;
+
+  if (rank == 0)
+    {
+      hid_t file, dset, fspace;
+      assert((file = H5Fopen(pconfig->replay_file, H5F_ACC_RDONLY, H5P_DEFAULT)) >= 0);
+      assert((dset = H5Dopen(file, pconfig->replay_dataset, H5P_DEFAULT)) >= 0);
+      assert((fspace = H5Dget_space(dset)) >= 0);
+      n = (unsigned long long) H5Sget_simple_extent_npoints(fspace);
+      assert(n > 0 && n <= INT_MAX);
+      pg->replay = (double*) malloc(n*sizeof(double));
+      assert(H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                     pg->replay) >= 0);
+      assert(H5Sclose(fspace) >= 0);
+      assert(H5Dclose(dset) >= 0);
+      assert(H5Fclose(file) >= 0);
+    }
+
+  MPI_Bcast(&n, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+  if (rank != 0)
+    pg->replay = (double*) malloc(n*sizeof(double));
+  MPI_Bcast(pg->replay, (int)n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  pg->nreplay = (size_t)n;
+}
+
+void create_generator(const configuration* pconfig, int rank,
+                      int my_proc_row, int my_proc_col, generator* pg)
+{
+  const int strong_scaling_flg = (pconfig->scaling == SCALING_STRONG);
+  partition part;
+
+  get_partition(pconfig, my_proc_row, my_proc_col, &part);
+  memset(pg, 0, sizeof(generator));
+  pg->kind = pconfig->generator;
+  pg->datatype = pconfig->datatype;
+  pg->rank = rank;
+  pg->rows = part.rows;
+  pg->cols = part.cols;
+  pg->ld = part.cols;
+  pg->row0 = part.row0;
+  pg->col0 = part.col0;
+  pg->total_rows = strong_scaling_flg ? pconfig->rows : pconfig->proc_rows*pconfig->rows;
+  pg->total_cols = strong_scaling_flg ? pconfig->cols : pconfig->proc_cols*pconfig->cols;
+
+  if (strcmp(generator_names[pg->kind], "replay") == 0)
+    load_replay(pconfig, rank, pg);
+}
+
+/*
+ *
+ * Convert a packed tile of doubles to the element type, in place. The
+ * narrower types are converted front to back, particles (wider than a
+ * double) back to front.
+ *
+ */
+
+static void convert_tile(unsigned int datatype, double* buf, size_t n)
+{
+  size_t k;
+
+  switch (datatype)
+    {
+    case DATATYPE_FLOAT:
+      {
+        float* p = (float*) buf;
+        for (k = 0; k < n; ++k)
+          p[k] = (float) buf[k];
+      }
+      break;
+    case DATATYPE_INT16:
+      {
+        short* p = (short*) buf;
+        for (k = 0; k < n; ++k)
+          {
+            const double v = 16384.0*buf[k];
+            p[k] = (short) ((v > 32767.0) ? 32767.0 : ((v < -32768.0) ? -32768.0 : v));
+          }
+      }
+      break;
+    case DATATYPE_COMPOUND:
+      {
+        particle* p = (particle*) buf;
+        for (k = n; k-- > 0; )
+          {
+            const double v = buf[k];
+            p[k].x = p[k].y = p[k].z = v;
+            p[k].mass = (float) v;
+            p[k].id = (int) k;
+          }
+      }
+      break;
+    default:
+      break;
+    }
+}
+
+void generate_tile(const generator* pg, double* buf, unsigned int istep,
+                   unsigned int iarray, metrics* pm)
+{
+  const char* kind = generator_names[pg->kind];
+  const size_t rows = pg->rows, cols = pg->cols, ld = pg->ld;
+  const uint64_t seed = stream(pg, istep, iarray);
+  size_t i, j;
+
+  pm->kernel -= MPI_Wtime();
+
+  if (strcmp(kind, "constant") == 0)
+    {
+      const double c = (double)(pg->rank + istep + iarray);
+      for (i = 0; i < rows; ++i)
+        for (j = 0; j < cols; ++j)
+          buf[i*ld + j] = c;
+    }
+  else if (strcmp(kind, "paraboloid") == 0 || strcmp(kind, "noisy") == 0)
+    { /* over the global [0,1]x[0,1] square, the apex wanders around */
+      const double dx = 1.0/(double)(pg->total_rows - 1);
+      const double dy = 1.0/(double)(pg->total_cols - 1);
+      const double x0 = 0.5 + 0.25*sin(0.1*istep);
+      const double y0 = 0.5 + 0.25*cos(0.1*iarray);
+      const double noise = (strcmp(kind, "noisy") == 0) ? NOISE : 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for private(j) if(rows*cols > KERNEL_OMP_MIN)
+#endif
+      for (i = 0; i < rows; ++i)
+        {
+          double* row = buf + i*ld;
+          const double x = (double)(pg->row0 + i)*dx;
+          const double dx2 = (x-x0)*(x-x0);
+          for (j = 0; j < cols; ++j)
+            {
+              const double y = (double)(pg->col0 + j)*dy;
+              row[j] = dx2 + (y-y0)*(y-y0);
+            }
+          if (noise > 0.0)
+            for (j = 0; j < cols; ++j)
+              row[j] += noise*(uniform(seed, i*cols + j) - 0.5);
+        }
+    }
+  else if (strcmp(kind, "random") == 0)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for private(j) if(rows*cols > KERNEL_OMP_MIN)
+#endif
+      for (i = 0; i < rows; ++i)
+        for (j = 0; j < cols; ++j)
+          buf[i*ld + j] = uniform(seed, i*cols + j);
+    }
+  else /* replay, starting at a position that depends on rank, step, and array */
+    {
+      const size_t n = pg->nreplay;
+      size_t k, len;
+      for (i = 0; i < rows; ++i)
+        for (j = 0, k = (size_t)((seed % n + i*cols) % n); j < cols; j += len, k = 0)
+          { /* wrap around at the end of the replayed data */
+            len = n - k;
+            if (len > cols - j)
+              len = cols - j;
+            memcpy(buf + i*ld + j, pg->replay + k, len*sizeof(double));
+          }
+    }
+
+  if (pg->datatype != DATATYPE_DOUBLE && ld == cols)
+    convert_tile(pg->datatype, buf, rows*cols);
+
+  pm->kernel += MPI_Wtime();
+}
+
+void close_generator(generator* pg)
+{
+  free(pg->replay);
+  pg->replay = NULL;
+  pg->nreplay = 0;
+}
@@ -0,0 +1,72 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include "configuration.h"
+#include "metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Data generators fill a rank's tile for a given (step, array). Except for
+ * the constant generator, the data depends on the step, the array, and the
+ * tile's position in the global array (i.e., the rank), so that filters
+ * don't see the same block over and over again.
+ *
+ *   constant   - a single value per tile
+ *   paraboloid - a smooth paraboloid whose apex moves with step and array
+ *   noisy      - the paraboloid plus a little uniform noise (lossless
+ *                compression must deal with noisy low-order bits)
+ *   random     - uniform random numbers in [0,1), incompressible
+ *   replay     - a slice of a user-supplied dataset (replay-file and
+ *                replay-dataset), read once and broadcast
+ *
+ * The tile is generated as doubles and, for the other element types,
+ * converted in place (packed, i.e., only if ld == cols): float and int16
+ * (scaled by 2^14 and clamped), and a particle per element with the value
+ * as its coordinates and mass, and its index (in the tile) as id.
+ */
+
+typedef struct
+{
+  unsigned int kind;        /* index into generator_names */
+  unsigned int datatype;    /* index into datatype_names */
+  int          rank;
+  size_t       rows;        /* the tile */
+  size_t       cols;
+  size_t       ld;          /* distance of the rows in the buffer (>= cols) */
+  size_t       row0;        /* the tile's origin in the global array */
+  size_t       col0;
+  size_t       total_rows;  /* the global array */
+  size_t       total_cols;
+  double*      replay;      /* the replayed data, if any */
+  size_t       nreplay;
+} generator;
+
+extern void create_generator(const configuration* pconfig, int rank,
+                             int my_proc_row, int my_proc_col, generator* pg);
+
+extern void generate_tile(const generator* pg, double* buf, unsigned int istep,
+                          unsigned int iarray, metrics* pm);
+
+/* The SplitMix64 finalizer, a counter-based hash (also seeds the random
+   read patterns) */
+
+extern uint64_t mix64(uint64_t x);
+
+extern void close_generator(generator* pg);
+
+#endif
@@ -11,7 +11,15 @@
 
 */
 
+#include "aggregate.h"
+#include "dataset.h"
+#include "generators.h"
+#include "param_space.h"
+#include "instrument.h"
+#include "object_store.h"
+#include "read_patterns.h"
 #include "read_test.h"
+#include "sweep.h"
 #include "utils.h"
 #include "write_test.h"
 
@@ -23,9 +31,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-#define  TEST_FOR(INI, CHK, CNT) for ((INI); (CHK); (CNT)) {
-#define  END_TEST }
+#include <unistd.h>
 
 #define CONFIG_FILE "hdf5_iotest.ini"
 
@@ -33,31 +39,37 @@ int main(int argc, char* argv[])
 {
   const char* ini = (argc > 1) ? argv[1] : CONFIG_FILE;
 
-  configuration config;
-  unsigned int strong_scaling_flg, coll_mpi_io_flg;
+  configuration config, lconfig, rconfig;
+  unsigned int strong_scaling_flg;
 
-  int size, rank, my_proc_row, my_proc_col;
+  int size, rank, my_proc_row, my_proc_col, lproc_row, lproc_col;
+  int node_size, node_rank, read_shift, read_rank, rproc_row, rproc_col;
+  MPI_Comm node_comm, io_comm;
+  int *node_tile, my_tile, read_tile, wsize, wrank;
   unsigned long my_rows, my_cols;
-
-  unsigned int irank, islow, ifill, ilay, ialig, imblk, ifmt, imod;
+  partition part, rpart;
+  plan wplan, rplan;
+  aggregator agg;
+  unsigned int agg_flg, ipattern;
+
+  param_space ps;
+  sweep sw;
+  char ckpt_key[CASE_KEY_LEN];
   unsigned int ckpt_flg;
-  restart_t ckpt;
-
-  char* slow_dim[2]      = { "step", "array" };
-  char* fill[2]          = { "true", "false" };
-  char* layout[2]        = { "contiguous", "chunked" };
-  hsize_t align_incr[2]  = { 1, 1 };
-  hsize_t align_thold[2] = { 0, 0 };
-  hsize_t mblk_size[2]   = { 2048, 0 };
-  char* fmt_low[2]       = { "earliest", "latest" };
-  char* mpi_mod[2]       = { "independent", "collective" };
 
-  hid_t fcpl, fapl, dapl, dxpl, lcpl, fapl_cpy, fapl_split;
+  hid_t fcpl, fapl, dapl, dxpl, lcpl, fapl_split, fapl_case, fapl_fmode, fapl_write;
+  hid_t fapl_read;
 
   double wall_time, create_time, write_phase, write_time, read_phase, read_time;
+  double write_kernel, case_begin, case_end;
+  double samples[NREP_STATS][MAX_REPETITIONS];
+  unsigned int irep, nreps, stop;
   timings ts;
+  metrics ms;
+  generator gen;
+  step_log slog, *plog = NULL;
   int icase = 0;
-  int nmod = 0;
+  unsigned int i;
 
   int         mpi_thread_lvl_provided = -1;
   MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_thread_lvl_provided);
@@ -74,22 +86,109 @@ int main(int argc, char* argv[])
     {
       uuid_t uuid;
       /* sensible defaults */
+      config.scaling = SCALING_WEAK;
       config.rank = 4;
+      config.slowest_dimension = SLOWDIM_STEP;
+      config.layout = LAYOUT_CONTIGUOUS;
+      config.fill_values = FILL_ON;
       config.hdf5_file[0] = '\0';
       config.csv_file[0] = '\0';
+      config.step_csv_file[0] = '\0';
+      config.markers = 0;
+      config.warmups = 0;
+      config.repetitions = 1;
+      config.reuse_file = 0;
+      config.reuse = 0;
+      config.ci_target = 0.0;
       config.restart = 0;
       config.split = 0;
+      config.core_backing_store = 1;
       config.delay.time_num = 0;
       config.async = 0;
+      config.async_buffers = 1;
       config.one_case = 0;
       config.HDF5perCase = 0;
-      config.compress_type[0] = '\0';
+      config.ncompressions = 0;
+      memset(&config.compression, 0, sizeof(dataset_filter));
+      strcpy(config.compression.label, "none");
+      config.compression_applied = 0;
+      config.aggregations = 1; /* none */
+      config.aggregation = AGGREGATION_NONE;
+      config.multi_dataset = 0;
+      config.append = 0;
+      config.precreate = 0;
+      config.selection_cache = 0;
+      config.file_modes = 1; /* shared */
+      config.file_mode = FILE_MODE_SHARED;
+      config.subfiling_stripe_size = 0;
+      config.subfiling_ioc_per_node = 0;
+      config.nchunk_scales = 1; /* a rank's tile */
+      config.chunk_scales[0][0] = config.chunk_scales[0][1] = 1.0;
+      config.nhints = 0;
+      config.nincludes = 0;
+      config.nexcludes = 0;
+      config.buffer_alignment = 0; /* the page size */
+      config.huge_pages = 0;
+      config.read_modes = 1; /* warm */
+      config.read_mode = READ_MODE_WARM;
+      config.read_shift = -1;
+      config.read_patterns = 1; /* same-as-write */
+      config.time_series_array = 0;
+      config.random_tiles = 0;
+      config.read_seed = 1;
+      config.drop_cache_command[0] = '\0';
+      config.upload_command[0] = '\0';
+      config.object_store_url[0] = '\0';
+      config.object_store_region[0] = '\0';
+      config.object_store_pbuf.size = 0; /* off */
+      config.object_store_pbuf.min_meta_perc = 0;
+      config.object_store_pbuf.min_raw_perc = 0;
+      config.fspace_strategies = 1; /* the library default, fsm-aggr */
+      config.fspace_strategy = H5F_FSPACE_STRATEGY_FSM_AGGR;
+      config.nthread_counts = 1;
+      config.thread_counts[0] = 1;
+      config.threads = 1;
+      config.npage_sizes = 1;
+      config.page_sizes[0] = 4096;
+      config.npage_buffers = 1;
+      config.page_buffers[0].size = 0; /* off */
+      config.page_buffers[0].min_meta_perc = 0;
+      config.page_buffers[0].min_raw_perc = 0;
+      config.nmdc_configs = 1;
+      config.mdc_configs[0].initial_size = 0; /* default */
+      config.mdc_configs[0].max_size = 0;
+      config.mdc_configs[0].evictions = 1;
+      config.coll_metadata_modes = 2; /* on */
+      config.coll_metadata = 1;
+      config.generators = 0; /* depends on compression, see below */
+      config.generator = 0;
+      config.datatypes = 1; /* double */
+      config.datatype = 0;
+      config.type_conversion = 0;
+      config.replay_file[0] = '\0';
+      config.replay_dataset[0] = '\0';
+      config.nchunk_caches = 1;
+      config.chunk_caches[0].nslots = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
+      config.chunk_caches[0].nbytes = H5D_CHUNK_CACHE_NBYTES_DEFAULT;
+      config.chunk_caches[0].w0     = H5D_CHUNK_CACHE_W0_DEFAULT;
 
       if (ini_parse(ini, handler, &config) < 0)
         {
           printf("Can't load '%s'\n", ini);
           return 1;
         }
+      check_compressions(&config);
+      if (config.generators == 0) /* something compressible, if it matters */
+        {
+          config.generators = 1u;
+          for (i = 0; i < config.ncompressions; ++i)
+            if (config.compressions[i].id != H5Z_FILTER_NONE)
+              config.generators = 1u << 1;
+        }
+      if (config.ncompressions == 0) /* none configured, or none available */
+        config.compressions[config.ncompressions++] = config.compression;
+      if (config.buffer_alignment == 0)
+        config.buffer_alignment = (unsigned long long) sysconf(_SC_PAGESIZE);
       if (config.csv_file[0] == '\0')
         {
           uuid_generate_time_safe(uuid);
@@ -105,7 +204,21 @@ int main(int argc, char* argv[])
     }
 
   /* broadcast the input parameters */
-  MPI_Bcast(&config, sizeof(configuration), MPI_BYTE, 0, MPI_COMM_WORLD);
+  broadcast_config(&config, 0, MPI_COMM_WORLD);
+
+  /* a process grid dimension of 0 is up to MPI_Dims_create */
+  if (config.proc_rows == 0 || config.proc_cols == 0)
+    {
+      int dims[2];
+      dims[0] = (int)config.proc_rows;
+      dims[1] = (int)config.proc_cols;
+      if ((dims[0] > 0 && size % dims[0] != 0) ||
+          (dims[1] > 0 && size % dims[1] != 0) ||
+          MPI_Dims_create(size, 2, dims) != MPI_SUCCESS)
+        dims[0] = dims[1] = 0; /* validate will complain */
+      config.proc_rows = (unsigned int)dims[0];
+      config.proc_cols = (unsigned int)dims[1];
+    }
 
   validate(&config, size);
 
@@ -113,35 +226,42 @@ int main(int argc, char* argv[])
     print_initial_config(ini, &config);
 
   ckpt_flg = 0;
-  if (config.restart == 1) {
-    if (rank == 0) /* rank 0 reads the last successful configuration */
-      {
-        restart(&ckpt, 
-                config.csv_file,
-                slow_dim,
-                fill,
-                layout,
-                fmt_low,
-                mpi_mod,
-                mblk_size,
-                align_incr);
-      }
-    /* broadcast the restart parameters */
-    MPI_Bcast(&ckpt, sizeof(ckpt), MPI_BYTE, 0, MPI_COMM_WORLD);
-    ckpt_flg = 1;
-  }
+  if (config.restart == 1)
+    {
+      if (rank == 0) /* rank 0 reads the key of the last successful case */
+        restart(config.csv_file, ckpt_key);
+      /* broadcast the restart key */
+      MPI_Bcast(ckpt_key, CASE_KEY_LEN, MPI_BYTE, 0, MPI_COMM_WORLD);
+      ckpt_flg = 1;
+    }
+
+  /* cold reads shift the ranks by a node, by default, so that no rank reads
+     tiles written (and cached) on its own node */
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                      MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &node_size);
+  MPI_Comm_rank(node_comm, &node_rank);
+  read_shift = ((config.read_shift < 0) ? node_size : config.read_shift) % size;
 
-  my_proc_row = rank / config.proc_cols;
-  my_proc_col = rank % config.proc_cols;
+  /* the node-aware decomposition, and one aggregator per node */
+  MPI_Comm_split(MPI_COMM_WORLD, (node_rank == 0) ? 0 : MPI_UNDEFINED, rank,
+                 &io_comm);
+  node_tile = (int*) malloc(size*sizeof(int));
+  node_tiles(node_comm, io_comm, node_tile);
 
   /* create the output CSV file */
   if (rank == 0 && config.restart == 0)
     create_output_file(config.csv_file);
   /* create the output checkpoint restart file */
 
-  strong_scaling_flg = (strncmp(config.scaling, "strong", 16) == 0);
-  my_rows = strong_scaling_flg ? config.rows/config.proc_rows : config.rows;
-  my_cols = strong_scaling_flg ? config.cols/config.proc_cols : config.cols;
+  /* and the per-step time series */
+  if (config.step_csv_file[0] != '\0')
+    {
+      open_step_log(config.step_csv_file, config.restart, &slog);
+      plog = &slog;
+    }
+
+  strong_scaling_flg = (config.scaling == SCALING_STRONG);
 
   assert((fcpl = H5Pcreate(H5P_FILE_CREATE)) >= 0);
   assert((fapl = H5Pcreate(H5P_FILE_ACCESS)) >= 0);
@@ -152,240 +272,366 @@ int main(int argc, char* argv[])
 
   if (size > 1 || (strncmp(config.single_process, "mpi-io-uni", 16) == 0))
     {
+      /* collective metadata operations are a test parameter */
       assert(H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL) >= 0);
-      assert(H5Pset_all_coll_metadata_ops(fapl, 1) >= 0);
-      assert(H5Pset_coll_metadata_write(fapl, 1) >= 0);
     }
   else
     if (strncmp(config.single_process, "core", 16) == 0)
-      assert(H5Pset_fapl_core(fapl, 67108864, 1) >= 0); /* 64 MB increments */
+      assert(H5Pset_fapl_core(fapl, 67108864, /* 64 MB increments */
+                              config.core_backing_store) >= 0);
+#ifdef H5_HAVE_DIRECT
+    else if (strncmp(config.single_process, "direct", 16) == 0)
+      /* the buffers' alignment is also the file system block size,
+         16 MB copy buffer for unaligned transfers */
+      assert(H5Pset_fapl_direct(fapl, config.buffer_alignment,
+                                config.buffer_alignment, 16777216) >= 0);
+#endif
     else
       assert(H5Pset_fapl_sec2(fapl) >= 0);
 
-  /* test collective and independent modes when parallel, and greater than 0 ranks */
-  if (size > 1) nmod = 1;
-
   char hdf5_filename[strlen(config.hdf5_file+4)];
-
-  /* use a macro to stop the indentation madness */
-
-  /* ======================================================================== */
-  /* dataset rank */
-  TEST_FOR (irank = 2, irank <= 4, ++irank);
-  if(config.restart == 1 && ckpt_flg == 1) irank = ckpt.irank;
-  config.rank = irank;
-
-  /* ======================================================================== */
-  /* slowest changing dimension */
-  TEST_FOR (islow = 0, islow <= 1, ++islow);
-  if(config.restart == 1 && ckpt_flg == 1) islow= ckpt.islow;
-  strncpy(config.slowest_dimension, slow_dim[islow],
-          sizeof(config.slowest_dimension));
-
-  /* ======================================================================== */
-  /* dataset layout */
-  TEST_FOR (ilay = 0, ilay <= 1, ++ilay);
-  if(config.restart == 1 && ckpt_flg == 1) ilay = ckpt.ilay;
-  strncpy(config.layout, layout[ilay], sizeof(config.layout));
-
-  /* ======================================================================== */
-  /* write fill values */
-  TEST_FOR (ifill = 0, ifill <= 1, ++ifill);
-  if(config.restart == 1 && ckpt_flg == 1) ifill = ckpt.ifill;
-  strncpy(config.fill_values, fill[ifill], sizeof(config.fill_values));
-
-  /* ======================================================================== */
-  /* alignment */
-  TEST_FOR (ialig = 0, ialig <= 1, ++ialig);
-  if(config.restart == 1 && ckpt_flg == 1) {
-    ialig = ckpt.ialig;
-    if (ialig == 1) {
-      align_incr[1]  = config.alignment_increment;
-      align_thold[1] = config.alignment_threshold;
-    }
-  }
-  if (ialig == 0) /* run the baseline first */
+  char rank_filename[PATH_MAX+16];
+  char read_filename[2*PATH_MAX+32];  /* or URL */
+
+  sw.pconfig = &config;
+  sw.requested = config;
+  sw.size = size;
+  sw.rank = rank;
+  sw.fcpl = fcpl;
+  sw.fapl = fapl;
+  sw.dapl = dapl;
+  sw.dxpl = dxpl;
+  sw.coll_mpi_io_flg = 0;
+  if (node_band(&config, node_comm, sw.band) < 0 &&
+      (config.aggregations & (1u << AGGREGATION_NODE_AGG)) && rank == 0)
+    printf("Warning: the nodes' tiles don't form bands of the same shape, "
+           "there are no node-agg cases.\n");
+  register_axes(&ps, &sw);
+  if (!sw.threadsafe && rank == 0 &&
+      (config.nthread_counts > 1 || config.thread_counts[0] > 1))
+    printf("Warning: the HDF5 library is not thread-safe (or there is no "
+           "OpenMP), there are no multi-threaded cases.\n");
+  if (!sw.object_store && rank == 0 &&
+      (config.read_modes & (1u << READ_MODE_OBJECT_STORE)))
+    printf("Warning: no ros3 VFD in the HDF5 library (or no object-store-url), "
+           "there are no object-store cases.\n");
+  assert(ps_check_filters(&ps) == 0);
+
+  while (ps_next(&ps))
     {
-      align_incr[1]  = config.alignment_increment;
-      align_thold[1] = config.alignment_threshold;
-      config.alignment_increment = align_incr[0];
-      config.alignment_threshold = align_thold[0];
-    }
-  else
-    { /* check if we need to run anything beyond the baseline */
-      if (align_incr[1] == 1 && align_thold[1] == 0)
-        continue;
-      else
+      ++icase;
+      ps_case_key(&ps, config.case_key, sizeof(config.case_key));
+
+      /* skip ahead to the last successful case */
+      if (ckpt_flg == 1)
         {
-          config.alignment_increment = align_incr[1];
-          config.alignment_threshold = align_thold[1];
+          if (strcmp(config.case_key, ckpt_key) != 0)
+            continue;
+          ckpt_flg = 0;
         }
-    }
-
-  assert(H5Pset_alignment(fapl, config.alignment_threshold,
-                          config.alignment_increment) >= 0);
 
-  /* ======================================================================== */
-  /* meta block size */
-  TEST_FOR (imblk = 0, imblk <= 1, ++imblk);
-  if(config.restart == 1 && ckpt_flg == 1) {
-    imblk = ckpt.imblk;
-    if (imblk == 1) {
-      mblk_size[1]  = config.meta_block_size;
-    }
-  }
-  if (imblk == 0) /* run the baseline first */
-    {
-      mblk_size[1]  = config.meta_block_size;
-      config.meta_block_size = mblk_size[0];
-    }
-  else
-    { /* check if we need to run anything beyond the baseline */
-      if (mblk_size[1] == 2048)
-        continue;
-      else
-          config.meta_block_size = mblk_size[1];
-    }
-  assert(H5Pset_meta_block_size(fapl, config.meta_block_size) >= 0);
-
-  /* ======================================================================== */
-  /* lower libver bound */
-  TEST_FOR (ifmt = 0, ifmt <= 1, ++ifmt);
-  if(config.restart == 1 && ckpt_flg == 1)  ifmt = ckpt.ifmt;
-  strncpy(config.libver_bound_low, fmt_low[ifmt],
-          sizeof(config.libver_bound_low));
-  assert(set_libver_bounds(&config, rank, fapl) >= 0);
-
-  /* ======================================================================== */
-  /* MPI-IO mode */
-  TEST_FOR (imod = 0, imod <= nmod, ++imod);
-  ++icase;
-  
-  if(config.one_case > 0 && config.one_case != icase) goto skip;
-  if(config.restart == 1 && ckpt_flg == 1) {
-    imod = ckpt.imod;
-    ckpt_flg = 0;
-  }
+      if(config.one_case > 0 && config.one_case != icase) continue;
 
-  if (size > 1)
-    {
-      if(config.split == 0 )
-        strncpy(config.mpi_io, mpi_mod[imod], sizeof(config.mpi_io)-1);
-      else /* split driver can't do collective I/O */
-        strncpy(config.mpi_io, mpi_mod[0], sizeof(config.mpi_io)-1);
+      /* Set the split file driver if requested.
+       * This needs to be done here so that the metadata and raw data fapl's
+       * parameters are completely set because some fapl APIs, like alignment,
+       * can't be applied to the split driver's fapl */
+      fapl_case = fapl;
+      if(config.split == 1 ) 
+        {
+          assert((fapl_split = H5Pcreate(H5P_FILE_ACCESS)) >= 0);
+          assert(H5Pset_fapl_split(fapl_split, "-m.h5", fapl, "-r.h5", fapl) >= 0);
+          fapl_case = fapl_split;
+        }
 
-      coll_mpi_io_flg = (strncmp(config.mpi_io, "collective", 15) == 0);
+      /* ######################################################################## */
 
-      if (coll_mpi_io_flg)
-        assert(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE) >= 0);
-      else
-        assert(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_INDEPENDENT) >= 0);
-    }
-  else
-    {
-      if( strncmp(config.single_process, "mpi-io-uni", 16) == 0 &&
-          strcmp(config.compress_type, "") != 0 ) {
-        assert(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE) >= 0);
-        coll_mpi_io_flg = 1;
-      }
-      strncpy(config.mpi_io, config.single_process, sizeof(config.mpi_io));
-      if (imod == 1 && config.restart == 1 )
-        continue;
-    }
+      validate(&config, size);
 
-  /* Set the split file driver if requested.
-   * This needs to be done here so that the metadata and raw data fapl's
-   * parameters are completely set because some fapl APIs, like alignment,
-   * can't be applied to the split driver's fapl */
-  if(config.split == 1 ) 
-    {
-      assert((fapl_split = H5Pcreate(H5P_FILE_ACCESS)) >= 0);
-      assert(H5Pset_fapl_split(fapl_split, "-m.h5", fapl, "-r.h5", fapl) >= 0);
-      fapl_cpy = fapl;
-      fapl = fapl_split;
-    }
+      strcpy( hdf5_filename, config.hdf5_file);
 
-  /* ######################################################################## */
+      if(config.HDF5perCase != 0)
+        {
+          char buf[5];
+          sprintf(buf, "%04d", icase);
 
-  validate(&config, size);
+          char * num;
+          num = strstr (hdf5_filename,"#");
+          strcpy (num+4, num+1);
+          strncpy (num,buf,4);
+        }
 
-  if (rank == 0)
-    print_current_config(&config);
+      /* the tile of a rank, in rank order or node-aware */
+      my_tile = (config.aggregation == AGGREGATION_NONE) ?
+        rank : node_tile[rank];
+      my_proc_row = my_tile / config.proc_cols;
+      my_proc_col = my_tile % config.proc_cols;
+      get_partition(&config, my_proc_row, my_proc_col, &part);
+      my_rows = part.rows;
+      my_cols = part.cols;
+
+      /* with a file per process, every rank's partition is a dataset of its own */
+      fapl_fmode = create_file_mode_fapl(&config, fapl_case);
+      lconfig = config;
+      lproc_row = my_proc_row;
+      lproc_col = my_proc_col;
+      strcpy(rank_filename, hdf5_filename);
+      if (config.file_mode == FILE_MODE_PER_PROCESS)
+        {
+          lconfig.rows = my_rows;
+          lconfig.cols = my_cols;
+          lconfig.proc_rows = lconfig.proc_cols = 1;
+          lproc_row = lproc_col = 0;
+          sprintf(rank_filename + strlen(rank_filename), ".%05d", rank);
+        }
 
-  strcpy( hdf5_filename, config.hdf5_file);
+      /* with node aggregation, the aggregators write their node's band as
+         the tile of a coarser decomposition, on a communicator of their own */
+      agg_flg = (config.aggregation == AGGREGATION_NODE_AGG);
+      fapl_write = fapl_fmode;
+      wsize = size;
+      wrank = rank;
+      if (agg_flg)
+        {
+          const int band_tile = my_tile - node_rank; /* the node's first tile */
+          create_aggregator(node_comm, sw.band,
+                            my_proc_row - band_tile / config.proc_cols,
+                            my_proc_col - band_tile % config.proc_cols,
+                            my_rows, my_cols, &agg);
+          lconfig.proc_rows /= sw.band[0];
+          lconfig.proc_cols /= sw.band[1];
+          if (!strong_scaling_flg)
+            {
+              lconfig.rows *= sw.band[0];
+              lconfig.cols *= sw.band[1];
+            }
+          lproc_row = (band_tile / config.proc_cols) / sw.band[0];
+          lproc_col = (band_tile % config.proc_cols) / sw.band[1];
+          if (node_rank == 0)
+            {
+              MPI_Comm comm;
+              MPI_Info info;
+              MPI_Comm_size(io_comm, &wsize);
+              MPI_Comm_rank(io_comm, &wrank);
+              assert((fapl_write = H5Pcopy(fapl_fmode)) >= 0);
+              assert(H5Pget_fapl_mpio(fapl_write, &comm, &info) >= 0);
+              assert(H5Pset_fapl_mpio(fapl_write, io_comm, info) >= 0);
+              MPI_Comm_free(&comm);
+              if (info != MPI_INFO_NULL)
+                MPI_Info_free(&info);
+            }
+        }
+      create_plan(&lconfig, lproc_row, lproc_col, &wplan);
+
+      /* what create_dcpl will make of the filter */
+      config.compression_applied = compression_applies(&lconfig, sw.coll_mpi_io_flg);
+
+      if (rank == 0)
+        print_current_config(&config);
+
+      /* the tiles (or file) to read */
+      read_rank = (config.read_mode == READ_MODE_COLD) ?
+        (rank + read_shift) % size : rank;
+      read_tile = (config.aggregation == AGGREGATION_NONE) ?
+        read_rank : node_tile[read_rank];
+      rproc_row = read_tile / config.proc_cols;
+      rproc_col = read_tile % config.proc_cols;
+      get_partition(&config, rproc_row, rproc_col, &rpart);
+      rconfig = config;
+      strcpy(read_filename, hdf5_filename);
+      if (config.file_mode == FILE_MODE_PER_PROCESS)
+        {
+          rconfig.rows = rpart.rows;
+          rconfig.cols = rpart.cols;
+          rconfig.proc_rows = rconfig.proc_cols = 1;
+          rproc_row = rproc_col = 0;
+          sprintf(read_filename + strlen(read_filename), ".%05d", read_rank);
+        }
+      fapl_read = fapl_fmode;
+      if (config.read_mode == READ_MODE_OBJECT_STORE)
+        { /* the uploaded copy, through the ros3 VFD */
+          char local[PATH_MAX+16];
+          strcpy(local, read_filename);
+          object_url(&config, local, read_filename, sizeof(read_filename));
+          fapl_read = create_object_store_fapl(&config, fapl_fmode);
+        }
+      create_plan(&rconfig, rproc_row, rproc_col, &rplan);
 
-  if(config.HDF5perCase != 0)
-    {
-      char buf[5];
-      sprintf(buf, "%04d", icase);
+      create_generator(&config, rank, my_proc_row, my_proc_col, &gen);
+      if (agg_flg) /* straight into the node's band */
+        gen.ld = wplan.tile.cols;
 
-      char * num;
-      num = strstr (hdf5_filename,"#");
-      strcpy (num+4, num+1);
-      strncpy (num,buf,4);
+      /* warmups and repetitions of the case, which can stop early once the
+         confidence intervals are tight enough */
+      mark_begin(&config, config.case_key);
+      case_begin = epoch_time();
+      for (irep = 0, nreps = 0; irep < config.warmups + config.repetitions; ++irep)
+        {
+          MPI_Barrier(MPI_COMM_WORLD);
+
+          wall_time = -MPI_Wtime();
+          read_time = write_time = create_time = 0.0;
+          reset_metrics(&ms);
+
+          /* rewrite the datasets of the previous run in place (appending
+             shrinks and regrows them, and an in-memory file is gone) */
+          lconfig.reuse = (config.reuse_file && irep > 0 &&
+                           !config.append && !in_memory(&config));
+
+          if (plog != NULL)
+            begin_step_phase(plog, icase, irep, config.case_key, "write");
+          write_phase = -MPI_Wtime();
+          if (agg_flg && node_rank != 0)
+            feed_aggregator(&config, &agg, &gen, plog, &write_time, &ms);
+          else
+            write_test(&lconfig, rank_filename, wsize, wrank, &wplan,
+                       fcpl, fapl_write, lcpl, dapl, dxpl, sw.coll_mpi_io_flg, &gen,
+                       agg_flg ? &agg : NULL, plog, &create_time, &write_time, &ms);
+          write_phase += MPI_Wtime();
+          if (plog != NULL)
+            end_step_phase(plog);
+          /* generating data is not I/O */
+          write_kernel = ms.kernel;
+          write_phase -= write_kernel;
+          strcpy(config.hints_effective, lconfig.hints_effective);
+
+          MPI_Barrier(MPI_COMM_WORLD);
+
+          if (in_memory(&config))
+            { /* the image the write phase left behind */
+              if (fapl_read != fapl_fmode)
+                assert(H5Pclose(fapl_read) >= 0);
+              fapl_read = file_image_fapl(fapl_fmode);
+            }
+
+          if (config.read_mode == READ_MODE_OBJECT_STORE)
+            { /* the read phase reads the uploaded file(s), see object_store.h */
+              if (config.file_mode == FILE_MODE_PER_PROCESS || rank == 0)
+                ms.upload = upload_file(&config, rank_filename);
+              MPI_Barrier(MPI_COMM_WORLD);
+            }
+
+          if (config.read_mode == READ_MODE_COLD)
+            { /* keep the read phase out of the page cache */
+              evict_file_cache(read_filename);
+              if (config.drop_cache_command[0] != '\0' && node_rank == 0)
+                if (system(config.drop_cache_command) != 0)
+                  printf("Warning: \"%s\" failed.\n", config.drop_cache_command);
+              MPI_Barrier(MPI_COMM_WORLD);
+            }
+
+          /* a cold read reads the tiles of read_rank as if it were that rank */
+          if (plog != NULL)
+            begin_step_phase(plog, icase, irep, config.case_key, "read");
+          read_phase = -MPI_Wtime();
+          mark_begin(&config, "read");
+          if (pattern_applies(&config, 0))
+            read_test(&rconfig, read_filename, size, read_rank, &rplan,
+                      fapl_read, dapl, dxpl, plog,
+                      &create_time, &read_time, &ms);
+
+          read_phase += MPI_Wtime();
+          mark_end(&config, "read");
+          if (plog != NULL)
+            end_step_phase(plog);
+          read_phase -= ms.kernel - write_kernel;
+
+          MPI_Barrier(MPI_COMM_WORLD);
+
+          /* the read patterns of analysis codes, timed one by one */
+          for (ipattern = 1; ipattern < READ_PATTERN_COUNT; ++ipattern)
+            if (pattern_applies(&config, ipattern))
+              {
+                mark_begin(&config, read_pattern_names[ipattern]);
+                pattern_test(&rconfig, &rplan, read_filename, ipattern, read_rank,
+                             rproc_row, rproc_col, fapl_read, dapl, dxpl, &ms);
+                mark_end(&config, read_pattern_names[ipattern]);
+                MPI_Barrier(MPI_COMM_WORLD);
+              }
+
+          wall_time += MPI_Wtime();
+          wall_time -= ms.kernel + ms.upload; /* neither is HDF5 I/O */
+
+          get_timings(write_phase, create_time, write_time, read_phase, read_time, &ms, &ts);
+
+          if (irep < config.warmups)
+            continue;
+          if (rank == 0)
+            {
+              samples[0][nreps] = wall_time;
+              samples[1][nreps] = ts.max_write_phase;
+              samples[2][nreps] = ts.max_write_time;
+              samples[3][nreps] = ts.max_read_phase;
+              samples[4][nreps] = ts.max_read_time;
+            }
+          ++nreps;
+          stop = (rank == 0) ? ci_converged(&config, samples, nreps) : 0;
+          MPI_Bcast(&stop, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+          if (stop)
+            break;
+        }
+      case_end = epoch_time();
+      mark_end(&config, config.case_key);
+      ts.case_begin = case_begin;
+      ts.case_end = case_end;
+      ts.repetitions = nreps;
+      if (rank == 0)
+        for (i = 0; i < NREP_STATS; ++i)
+          summarize(samples[i], nreps, &ts.rep_stats[i]);
+      if (agg_flg)
+        {
+          close_aggregator(&agg);
+          if (fapl_write != fapl_fmode)
+            assert(H5Pclose(fapl_write) >= 0);
+        }
+      close_generator(&gen);
+      close_plan(&rplan);
+      close_plan(&wplan);
+
+      /* logical vs. stored dataset bytes (not timed) */
+      ts.compression_ratio = 1.0;
+      if (config.compression_applied)
+        ts.compression_ratio = compression_ratio(&config, rank_filename,
+                                                 in_memory(&config) ? fapl_read : fapl_fmode);
+      if (fapl_read != fapl_fmode)
+        assert(H5Pclose(fapl_read) >= 0);
+
+      if (rank == 0)
+        print_results(&config, hdf5_filename, wall_time, &ts);
+      assert(H5Pclose(fapl_fmode) >= 0);
+  
+      if (config.split == 1) 
+        assert(H5Pclose(fapl_split) >= 0); /* close the split driver fapl */
+
+      /* clean up the hdf5 files for the case of an HDF5 file per case */
+      if(config.HDF5perCase != 0 && rank == 0) {
+        int len = 2*strlen(hdf5_filename) + 12;
+        char* command = malloc( len );
+        strcpy( command, "rm -f " );
+        strcat( command,  hdf5_filename);
+        if (config.file_mode != FILE_MODE_SHARED) { /* the rank files or subfiles */
+          strcat( command, " " );
+          strcat( command,  hdf5_filename);
+          strcat( command, ".*" );
+        }
+        system(command);
+        free(command);
+      }
+  
+      if(config.one_case > 0) break;
     }
 
-  MPI_Barrier(MPI_COMM_WORLD);
-
-  wall_time = -MPI_Wtime();
-  read_time = write_time = create_time = 0.0;
-
-  write_phase = -MPI_Wtime();
-  write_test(&config, hdf5_filename, size, rank, my_proc_row, my_proc_col, my_rows, my_cols,
-             fcpl, fapl, lcpl, dapl, dxpl, coll_mpi_io_flg,
-             &create_time, &write_time);
-  write_phase += MPI_Wtime();
-
-  MPI_Barrier(MPI_COMM_WORLD);
-
-  read_phase = -MPI_Wtime();
-  read_test(&config, hdf5_filename, size, rank, my_proc_row, my_proc_col, my_rows, my_cols,
-            fapl, dapl, dxpl,
-            &create_time, &read_time);
+  if (ckpt_flg == 1 && rank == 0)
+    printf("The restart case \"%s\" is not in the parameter space.\n", ckpt_key);
 
-  read_phase += MPI_Wtime();
+  if (plog != NULL)
+    close_step_log(plog);
 
-  MPI_Barrier(MPI_COMM_WORLD);
-
-  wall_time += MPI_Wtime();
-
-  get_timings(write_phase, create_time, write_time, read_phase, read_time, &ts);
-
-  if (rank == 0)
-    print_results(&config, hdf5_filename, wall_time, &ts);
-  
-  if (config.split == 1) 
-    {
-      assert(H5Pclose(fapl) >= 0); /* close the split driver fapl */
-      fapl = fapl_cpy;
-    }
-
-  /* clean up the hdf5 files for the case of an HDF5 file per case */
-  if(config.HDF5perCase != 0 && rank == 0) {
-    int len = strlen(hdf5_filename) + 8;
-    char* command = malloc( len );
-    strcpy( command, "rm -f " );
-    strcat( command,  hdf5_filename);
-    system(command);
-    free(command);
-  }
-  
-  if(config.one_case > 0) goto exitloop;
- skip:
-  continue;
-
-  /* ######################################################################## */
-
-  END_TEST /* MPI-IO mode */
-  END_TEST /* libver bound */
-  END_TEST /* meta block size */
-  END_TEST /* alignment */
-  END_TEST /* fill */
-  END_TEST /* layout */
-  END_TEST /* slow dim. */
-  END_TEST /* rank */
-
- exitloop:
+  free(node_tile);
+  free_file_image();
+  if (io_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&io_comm);
+  MPI_Comm_free(&node_comm);
 
   assert(H5Pclose(lcpl) >= 0);
   assert(H5Pclose(dxpl) >= 0);
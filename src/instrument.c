@@ -0,0 +1,89 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "instrument.h"
+
+#ifdef HAVE_CALIPER
+#include <caliper/cali.h>
+#endif
+#ifdef HAVE_NVTX
+#include <nvToolsExt.h>
+#endif
+
+#include <assert.h>
+#include <sys/time.h>
+
+void mark_begin(const configuration* pconfig, const char* region)
+{
+  if (pconfig->markers == 0)
+    return;
+  MPI_Pcontrol(1, region);
+#ifdef HAVE_CALIPER
+  cali_begin_region(region);
+#endif
+#ifdef HAVE_NVTX
+  nvtxRangePushA(region);
+#endif
+}
+
+void mark_end(const configuration* pconfig, const char* region)
+{
+  if (pconfig->markers == 0)
+    return;
+#ifdef HAVE_NVTX
+  nvtxRangePop();
+#endif
+#ifdef HAVE_CALIPER
+  cali_end_region(region);
+#endif
+  MPI_Pcontrol(-1, region);
+}
+
+double epoch_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + 1.0e-6*(double)tv.tv_usec;
+}
+
+void count_io_mode(hid_t dxpl, metrics* pm)
+{
+  H5D_mpio_actual_io_mode_t mode;
+  uint32_t local_cause, global_cause;
+
+  assert(H5Pget_mpio_actual_io_mode(dxpl, &mode) >= 0);
+  if (mode == H5D_MPIO_NO_COLLECTIVE || mode == H5D_MPIO_CHUNK_INDEPENDENT)
+    pm->indep_ios += 1.0;
+  else /* collective, or collective for some chunks */
+    pm->coll_ios += 1.0;
+
+  assert(H5Pget_mpio_no_collective_cause(dxpl, &local_cause, &global_cause) >= 0);
+  pm->no_coll_cause |= (unsigned int)(local_cause | global_cause);
+}
+
+void file_counters(const configuration* pconfig, hid_t file, metrics* pm)
+{
+  assert(H5Fget_mdc_hit_rate(file, &pm->mdc_hit_rate) >= 0);
+
+  /* the statistics exist only with a page buffer */
+  if (pconfig->pbuf.size > 0)
+    {
+      unsigned accesses[2], hits[2], misses[2], evictions[2], bypasses[2];
+      assert(H5Fget_page_buffering_stats(file, accesses, hits, misses,
+                                         evictions, bypasses) >= 0);
+      pm->pb_accesses[0] = accesses[0];
+      pm->pb_accesses[1] = accesses[1];
+      pm->pb_hits[0] = hits[0];
+      pm->pb_hits[1] = hits[1];
+    }
+}
@@ -0,0 +1,52 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include "configuration.h"
+#include "metrics.h"
+
+#include "hdf5.h"
+
+/*
+ * Markers and counters to correlate profiles and traces with the cases.
+ *
+ * With markers = true, each case is a region named by its case key, with
+ * nested create, write, close, and read regions (and one per read pattern).
+ * Regions go to MPI_Pcontrol (level 1 enters, -1 leaves a named region,
+ * the convention of IPM and others), and, if configured --with-caliper or
+ * --with-nvtx, to Caliper or NVTX. Tools without a region API (Darshan
+ * DXT, Recorder) can use the case-begin and case-end time stamps of the
+ * CSV file.
+ */
+
+extern void mark_begin(const configuration* pconfig, const char* region);
+
+extern void mark_end(const configuration* pconfig, const char* region);
+
+/* Seconds since the epoch (for the case time stamps) */
+
+extern double epoch_time(void);
+
+/* Count the actual I/O mode (H5Pget_mpio_actual_io_mode) of the last
+   transfer, and why it wasn't collective (H5Pget_mpio_no_collective_cause) */
+
+extern void count_io_mode(hid_t dxpl, metrics* pm);
+
+/* The metadata cache hit rate and page buffer hits of an open file */
+
+extern void file_counters(const configuration* pconfig, hid_t file,
+                          metrics* pm);
+
+#endif
@@ -0,0 +1,157 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "metrics.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void reset_metrics(metrics* pm)
+{
+  memset(pm, 0, sizeof(metrics));
+}
+
+/*
+ *
+ * Record a single latency sample [s]
+ *
+ */
+
+void hist_add(histogram* ph, double t)
+{
+  double x = t/HIST_MIN;
+  int e, bin = 0;
+
+  if (x >= 1.0)
+    {
+      /* x = m*2^e with m in [0.5, 1), i.e., x is in octave e-1 */
+      double m = frexp(x, &e);
+      bin = 1 + (e-1)*HIST_SUB + (int)((2.0*m - 1.0)*HIST_SUB);
+      if (bin >= HIST_NBINS)
+        bin = HIST_NBINS - 1;
+    }
+
+  ++ph->bins[bin];
+  ++ph->count;
+  if (t > ph->max)
+    ph->max = t;
+}
+
+/*
+ *
+ * Merge the histograms of all ranks on rank 0
+ *
+ */
+
+void hist_merge(const histogram* local, histogram* global)
+{
+  memset(global, 0, sizeof(histogram));
+
+  MPI_Reduce(&local->count, &global->count, 1, MPI_UNSIGNED_LONG_LONG,
+             MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&local->max, &global->max, 1, MPI_DOUBLE,
+             MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(local->bins, global->bins, HIST_NBINS, MPI_UNSIGNED_LONG_LONG,
+             MPI_SUM, 0, MPI_COMM_WORLD);
+}
+
+/* upper edge of a histogram bucket [s] */
+static double bin_edge(int bin)
+{
+  if (bin == 0)
+    return HIST_MIN;
+  return ldexp(HIST_MIN, (bin-1)/HIST_SUB) *
+    (1.0 + (double)((bin-1)%HIST_SUB + 1)/HIST_SUB);
+}
+
+/*
+ *
+ * Estimate p50, p90, p99, p99.9 (bucket upper edges), and the maximum
+ *
+ */
+
+void hist_percentiles(const histogram* ph, double pct[NPCT])
+{
+  static const double q[NPCT-1] = { 0.5, 0.9, 0.99, 0.999 };
+  unsigned long long cum = 0, target;
+  int i, bin = 0;
+
+  for (i = 0; i < NPCT; ++i)
+    pct[i] = 0.0;
+  if (ph->count == 0)
+    return;
+
+  for (i = 0; i < NPCT-1; ++i)
+    {
+      target = (unsigned long long)ceil(q[i]*(double)ph->count);
+      if (target == 0)
+        target = 1;
+      while (bin < HIST_NBINS && cum + ph->bins[bin] < target)
+        cum += ph->bins[bin++];
+      pct[i] = (bin < HIST_NBINS) ? bin_edge(bin) : ph->max;
+      if (pct[i] > ph->max)
+        pct[i] = ph->max;
+    }
+  pct[NPCT-1] = ph->max;
+}
+
+/*
+ *
+ * Summary statistics of repeated measurements
+ *
+ */
+
+static int compare_doubles(const void* a, const void* b)
+{
+  const double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+/* two-sided 95% quantiles of Student's t distribution by degrees of freedom */
+static double t95(unsigned int df)
+{
+  static const double t[30] =
+    { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+  return (df <= 30) ? t[df-1] : 1.960;
+}
+
+void summarize(const double* x, unsigned int n, summary* ps)
+{
+  double* sorted;
+  double ss = 0.0;
+  unsigned int i;
+
+  memset(ps, 0, sizeof(summary));
+  if (n == 0)
+    return;
+
+  for (i = 0; i < n; ++i)
+    ps->mean += x[i];
+  ps->mean /= n;
+
+  sorted = (double*) malloc(n*sizeof(double));
+  memcpy(sorted, x, n*sizeof(double));
+  qsort(sorted, n, sizeof(double), compare_doubles);
+  ps->median = (n % 2) ? sorted[n/2] : 0.5*(sorted[n/2 - 1] + sorted[n/2]);
+  free(sorted);
+
+  if (n < 2)
+    return;
+  for (i = 0; i < n; ++i)
+    ss += (x[i] - ps->mean)*(x[i] - ps->mean);
+  ps->stddev = sqrt(ss/(n - 1));
+  ps->ci95 = t95(n - 1)*ps->stddev/sqrt((double)n);
+}
@@ -0,0 +1,105 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "configuration.h"
+
+#include "hdf5.h"
+
+/*
+ * Fixed-bucket, log-scale latency histogram. Each power of two above
+ * HIST_MIN seconds is split into HIST_SUB linear buckets, i.e., the
+ * relative bucket width is at most 1/HIST_SUB. The range covers
+ * HIST_MIN * 2^HIST_OCTAVES (about 30 hours); anything above lands in
+ * the last bucket.
+ */
+
+#define HIST_MIN     1.0e-7
+#define HIST_OCTAVES 40
+#define HIST_SUB     8
+#define HIST_NBINS   (HIST_OCTAVES*HIST_SUB + 1)
+
+/* reported percentiles: p50, p90, p99, p99.9, max */
+#define NPCT 5
+
+typedef struct
+{
+  unsigned long long count;
+  double             max;
+  unsigned long long bins[HIST_NBINS];
+} histogram;
+
+/* Per-rank, per-case measurements collected by the write and read tests */
+
+typedef struct
+{
+  histogram create;      /* create_dataset() */
+  histogram select;      /* create_selection() */
+  histogram write;       /* H5Dwrite */
+  histogram read;        /* H5Dread */
+  histogram extend;      /* H5Dset_extent (append mode) */
+  double    write_bytes; /* bytes moved by H5Dwrite */
+  double    read_bytes;  /* bytes moved by H5Dread */
+  double    async_wait;  /* time blocked waiting for async writes */
+  double    async_exec;  /* execution time reported for async writes */
+  /* time to drain the async metadata event sets */
+  double    drain_file;
+  double    drain_create;
+  double    drain_open;
+  double    drain_close;
+  double    flush;       /* H5Fflush before closing the file */
+  double    kernel;      /* generating and verifying data (not I/O) */
+  double    aggregate;   /* waiting for the other ranks of a node */
+  double    thread_io;   /* multi-threaded transfers (see threads.h) */
+  double    thread_wait; /* the threads' estimated wait for the lock */
+  /* the start of the read phase (e.g., from an object store) */
+  double    upload;      /* uploading the file (see object_store.h) */
+  double    read_open;   /* H5Fopen of the read phase */
+  double    first_read;  /* the first H5Dread ... */
+  double    first_read_bytes;  /* ... and the bytes it moved */
+  /* what the library did (see instrument.h) */
+  double    coll_ios;            /* collective transfers */
+  double    indep_ios;           /* independent transfers */
+  unsigned int no_coll_cause;    /* H5D_mpio_no_collective_cause_t bits */
+  double    mdc_hit_rate;        /* of the written file */
+  double    pb_accesses[2];      /* page buffer, metadata and raw data */
+  double    pb_hits[2];
+  /* the read patterns other than same-as-write (see read_patterns.h) */
+  double    pattern_time[READ_PATTERN_COUNT];
+  double    pattern_bytes[READ_PATTERN_COUNT];
+} metrics;
+
+extern void reset_metrics(metrics* pm);
+
+extern void hist_add(histogram* ph, double t);
+
+extern void hist_merge(const histogram* local, histogram* global);
+
+extern void hist_percentiles(const histogram* ph, double pct[NPCT]);
+
+/* Mean, sample standard deviation, median, and the half-width of the 95%
+   confidence interval of the mean (Student's t) of repeated measurements */
+
+typedef struct
+{
+  double mean;
+  double stddev;
+  double median;
+  double ci95;
+} summary;
+
+extern void summarize(const double* x, unsigned int n, summary* ps);
+
+#endif
@@ -0,0 +1,111 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "object_store.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+unsigned int object_store_supported(void)
+{
+#ifdef H5_HAVE_ROS3_VFD
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+double upload_file(const configuration* pconfig, const char* fname)
+{
+  char command[2*PATH_MAX + 80];
+  const char *p = pconfig->upload_command, *q;
+  size_t n = 0;
+  double t;
+
+  if (pconfig->upload_command[0] == '\0')
+    return 0.0;
+
+  /* replace each {} by the file name */
+  while ((q = strstr(p, "{}")) != NULL && n < sizeof(command))
+    {
+      n += snprintf(command + n, sizeof(command) - n, "%.*s%s",
+                    (int)(q - p), p, fname);
+      p = q + 2;
+    }
+  if (n < sizeof(command))
+    snprintf(command + n, sizeof(command) - n, "%s", p);
+
+  t = -MPI_Wtime();
+  if (system(command) != 0)
+    printf("Warning: \"%s\" failed.\n", command);
+  t += MPI_Wtime();
+  return t;
+}
+
+void object_url(const configuration* pconfig, const char* fname,
+                char* url, size_t len)
+{
+  const char* base = strrchr(fname, '/');
+  const size_t n = strlen(pconfig->object_store_url);
+
+  base = (base != NULL) ? base + 1 : fname;
+  snprintf(url, len, "%s%s%s", pconfig->object_store_url,
+           (n > 0 && pconfig->object_store_url[n-1] == '/') ? "" : "/", base);
+}
+
+hid_t create_object_store_fapl(const configuration* pconfig, hid_t fapl)
+{
+  hid_t result;
+
+  /* the metadata cache, library version bounds, etc. of the other reads */
+  assert((result = H5Pcopy(fapl)) >= 0);
+#ifdef H5_HAVE_PARALLEL
+  /* the reads are independent */
+  assert(H5Pset_all_coll_metadata_ops(result, 0) >= 0);
+  assert(H5Pset_coll_metadata_write(result, 0) >= 0);
+#endif
+#ifdef H5_HAVE_ROS3_VFD
+  {
+    const char* id = getenv("AWS_ACCESS_KEY_ID");
+    const char* key = getenv("AWS_SECRET_ACCESS_KEY");
+    H5FD_ros3_fapl_t fa;
+
+    memset(&fa, 0, sizeof(fa));
+    fa.version = H5FD_CURR_ROS3_FAPL_T_VERSION;
+    fa.authenticate = (pconfig->object_store_region[0] != '\0' &&
+                       id != NULL && key != NULL);
+    if (fa.authenticate)
+      {
+        strncpy(fa.aws_region, pconfig->object_store_region,
+                H5FD_ROS3_MAX_REGION_LEN);
+        strncpy(fa.secret_id, id, H5FD_ROS3_MAX_SECRET_ID_LEN);
+        strncpy(fa.secret_key, key, H5FD_ROS3_MAX_SECRET_KEY_LEN);
+      }
+    assert(H5Pset_fapl_ros3(result, &fa) >= 0);
+#if H5_VERSION_GE(1,14,2)
+    if (fa.authenticate && getenv("AWS_SESSION_TOKEN") != NULL)
+      assert(H5Pset_fapl_ros3_token(result, getenv("AWS_SESSION_TOKEN")) >= 0);
+#endif
+  }
+#endif
+
+  if (pconfig->object_store_pbuf.size > 0 &&
+      pconfig->fspace_strategy == H5F_FSPACE_STRATEGY_PAGE &&
+      pconfig->object_store_pbuf.size >= pconfig->page_size)
+    assert(H5Pset_page_buffer_size(result, pconfig->object_store_pbuf.size,
+                                   pconfig->object_store_pbuf.min_meta_perc,
+                                   pconfig->object_store_pbuf.min_raw_perc) >= 0);
+  return result;
+}
@@ -0,0 +1,55 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef OBJECT_STORE_H
+#define OBJECT_STORE_H
+
+#include "configuration.h"
+
+#include "hdf5.h"
+
+#include <stddef.h>
+
+/*
+ * Reads from an object store (read-mode = object-store). After the write
+ * phase, the file (with a file per process, each rank's file) is uploaded
+ * with upload-command, and the read phase reads it back through the
+ * read-only S3 VFD (ros3) from object-store-url/<file name>. Requests
+ * are signed (AWS V4) if object-store-region and the AWS_ACCESS_KEY_ID and
+ * AWS_SECRET_ACCESS_KEY environment variables are set (AWS_SESSION_TOKEN
+ * for temporary credentials, with HDF5 1.14.2 and later). An object-store
+ * VOL connector selected with HDF5_VOL_CONNECTOR applies to the read phase
+ * as to any other.
+ */
+
+/* Is the ros3 VFD in the library? */
+
+extern unsigned int object_store_supported(void);
+
+/* Upload a file with upload-command (a "{}" in the command is replaced by
+   the file name), returns the time it took */
+
+extern double upload_file(const configuration* pconfig, const char* fname);
+
+/* The URL of the uploaded copy of a file */
+
+extern void object_url(const configuration* pconfig, const char* fname,
+                       char* url, size_t len);
+
+/* A copy of the case's file access property list fapl for reading from
+   the object store, with object-store-page-buffer if the file was written
+   with paged aggregation */
+
+extern hid_t create_object_store_fapl(const configuration* pconfig, hid_t fapl);
+
+#endif
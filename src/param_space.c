@@ -0,0 +1,240 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "param_space.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LABEL_LEN 512
+
+void ps_init(param_space* ps, void* ctx, const configuration* pconfig)
+{
+  memset(ps, 0, sizeof(param_space));
+  ps->ctx = ctx;
+  ps->pconfig = pconfig;
+}
+
+void ps_add_axis(param_space* ps, const char* name, unsigned int count,
+                 axis_label_fn label, axis_apply_fn apply)
+{
+  assert(ps->naxes < MAX_AXES);
+  ps->axes[ps->naxes].name = name;
+  ps->axes[ps->naxes].count = count;
+  ps->axes[ps->naxes].label = label;
+  ps->axes[ps->naxes].apply = apply;
+  ++ps->naxes;
+}
+
+/* The axis named by a filter term "name=alternatives", -1 if there's none */
+
+static int find_axis(const param_space* ps, const char* term)
+{
+  const char* eq = strchr(term, '=');
+  size_t len;
+  unsigned int k;
+
+  if (eq == NULL)
+    return -1;
+  len = (size_t)(eq - term);
+  for (k = 0; k < ps->naxes; ++k)
+    if (strlen(ps->axes[k].name) == len &&
+        strncmp(ps->axes[k].name, term, len) == 0)
+      return (int)k;
+  return -1;
+}
+
+/* Does the current value of the term's axis match one of its alternatives? */
+
+static int match_term(const param_space* ps, const char* term, int k)
+{
+  char label[LABEL_LEN];
+  const char *alt = strchr(term, '=') + 1, *end;
+  size_t len;
+
+  ps->axes[k].label(ps->ctx, ps->index[k], label, sizeof(label));
+  len = strlen(label);
+  while (1)
+    {
+      end = strchr(alt, '|');
+      if (end == NULL)
+        return strcmp(alt, label) == 0;
+      if ((size_t)(end - alt) == len && strncmp(alt, label, len) == 0)
+        return 1;
+      alt = end + 1;
+    }
+}
+
+/*
+ *
+ * Check the current case against the filters. If it fails, *skip is set
+ * to the innermost axis the failure depends on.
+ *
+ */
+
+static int pass_filters(const param_space* ps, unsigned int* skip)
+{
+  char buf[FILTER_LEN], *term, *save;
+  unsigned int i, matched, innermost;
+  int k;
+
+  for (i = 0; i < ps->pconfig->nincludes; ++i)
+    { /* every term must match */
+      strcpy(buf, ps->pconfig->includes[i]);
+      for (term = strtok_r(buf, " ", &save); term != NULL;
+           term = strtok_r(NULL, " ", &save))
+        {
+          k = find_axis(ps, term);
+          if (!match_term(ps, term, k))
+            {
+              *skip = (unsigned int)k;
+              return 0;
+            }
+        }
+    }
+
+  for (i = 0; i < ps->pconfig->nexcludes; ++i)
+    { /* the case is excluded if every term matches */
+      strcpy(buf, ps->pconfig->excludes[i]);
+      matched = 1;
+      innermost = 0;
+      for (term = strtok_r(buf, " ", &save); term != NULL && matched;
+           term = strtok_r(NULL, " ", &save))
+        {
+          k = find_axis(ps, term);
+          matched = match_term(ps, term, k);
+          if ((unsigned int)k > innermost)
+            innermost = (unsigned int)k;
+        }
+      if (matched)
+        {
+          *skip = innermost;
+          return 0;
+        }
+    }
+
+  return 1;
+}
+
+/*
+ *
+ * Make sure all filter terms name an axis
+ *
+ */
+
+int ps_check_filters(const param_space* ps)
+{
+  char buf[FILTER_LEN], *term, *save;
+  unsigned int i;
+
+  for (i = 0; i < ps->pconfig->nincludes + ps->pconfig->nexcludes; ++i)
+    {
+      strcpy(buf, (i < ps->pconfig->nincludes) ?
+             ps->pconfig->includes[i] :
+             ps->pconfig->excludes[i - ps->pconfig->nincludes]);
+      for (term = strtok_r(buf, " ", &save); term != NULL;
+           term = strtok_r(NULL, " ", &save))
+        if (find_axis(ps, term) < 0)
+          {
+            printf("Unknown parameter in filter term \"%s\".\n", term);
+            return -1;
+          }
+    }
+  return 0;
+}
+
+/* Skip the remaining values of all axes inside axis k */
+
+static void skip_inner(param_space* ps, unsigned int k)
+{
+  unsigned int j;
+  for (j = k+1; j < ps->naxes; ++j)
+    ps->index[j] = ps->axes[j].count - 1;
+}
+
+/* Step to the next point of the cross product */
+
+static int advance(param_space* ps)
+{
+  int k;
+
+  if (!ps->started)
+    {
+      ps->started = 1;
+      for (k = 0; k < (int)ps->naxes; ++k)
+        if (ps->axes[k].count == 0)
+          return 0;
+      return 1;
+    }
+
+  for (k = (int)ps->naxes - 1; k >= 0; --k)
+    {
+      if (++ps->index[k] < ps->axes[k].count)
+        return 1;
+      ps->index[k] = 0;
+    }
+  return 0;
+}
+
+/*
+ *
+ * Advance to the next case that passes the filters, and apply it.
+ * Returns 0 when the parameter space is exhausted.
+ *
+ */
+
+int ps_next(param_space* ps)
+{
+  unsigned int k, skip;
+
+  while (advance(ps))
+    {
+      if (!pass_filters(ps, &skip))
+        {
+          skip_inner(ps, skip);
+          continue;
+        }
+      for (k = 0; k < ps->naxes; ++k)
+        if (!ps->axes[k].apply(ps->ctx, ps->index[k]))
+          break;
+      if (k < ps->naxes)
+        { /* nothing inside this axis applies either */
+          skip_inner(ps, k);
+          continue;
+        }
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ *
+ * The key of the current case, "name=label" terms separated by spaces
+ *
+ */
+
+void ps_case_key(const param_space* ps, char* buf, size_t len)
+{
+  char label[LABEL_LEN];
+  size_t n = 0;
+  unsigned int k;
+
+  buf[0] = '\0';
+  for (k = 0; k < ps->naxes && n < len; ++k)
+    {
+      ps->axes[k].label(ps->ctx, ps->index[k], label, sizeof(label));
+      n += snprintf(buf + n, len - n, "%s%s=%s", (k > 0) ? " " : "",
+                    ps->axes[k].name, label);
+    }
+}
@@ -0,0 +1,72 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef PARAM_SPACE_H
+#define PARAM_SPACE_H
+
+#include "configuration.h"
+
+#include <stddef.h>
+
+/*
+ * The parameter space is the cross product of a list of axes, the first
+ * axis varies slowest. Each axis has a name, a number of values, and two
+ * callbacks:
+ *
+ *   label - the text representation of a value, which is what the include
+ *           and exclude filters match and what goes into the case key
+ *   apply - make a value current, e.g., update the configuration and
+ *           property lists; returns 0 if the value doesn't apply given the
+ *           values of the axes before it, which skips the case
+ *
+ * A case key is a list of "name=label" terms separated by spaces. A filter
+ * has the same syntax, except that a term can list alternatives separated
+ * by '|'. A case must match every include filter and no exclude filter.
+ */
+
+#define MAX_AXES 32
+
+typedef void (*axis_label_fn)(void* ctx, unsigned int i, char* buf, size_t len);
+
+typedef int (*axis_apply_fn)(void* ctx, unsigned int i);
+
+typedef struct
+{
+  const char*   name;
+  unsigned int  count;
+  axis_label_fn label;
+  axis_apply_fn apply;
+} axis;
+
+typedef struct
+{
+  void*                ctx;
+  const configuration* pconfig;   /* the include and exclude filters */
+  unsigned int         naxes;
+  axis                 axes[MAX_AXES];
+  unsigned int         index[MAX_AXES];
+  int                  started;
+} param_space;
+
+extern void ps_init(param_space* ps, void* ctx, const configuration* pconfig);
+
+extern void ps_add_axis(param_space* ps, const char* name, unsigned int count,
+                        axis_label_fn label, axis_apply_fn apply);
+
+extern int ps_check_filters(const param_space* ps);
+
+extern int ps_next(param_space* ps);
+
+extern void ps_case_key(const param_space* ps, char* buf, size_t len);
+
+#endif
@@ -0,0 +1,193 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "read_patterns.h"
+
+#include "dataset.h"
+#include "generators.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+unsigned int pattern_applies(const configuration* pconfig,
+                             unsigned int ipattern)
+{
+  if ((pconfig->read_patterns & (1u << ipattern)) == 0)
+    return 0;
+  /* the other ranks' tiles are in their own files */
+  return ipattern == 0 || ipattern == 1 ||
+    pconfig->file_mode != FILE_MODE_PER_PROCESS;
+}
+
+static unsigned int pattern_reads(const configuration* pconfig,
+                                  unsigned int ipattern)
+{
+  if (ipattern == 1)
+    return pconfig->steps;
+  if (ipattern == 3 && pconfig->random_tiles > 0)
+    return pconfig->random_tiles;
+  return pconfig->steps*pconfig->arrays;
+}
+
+/*
+ *
+ * The (step, array) and region of the k-th read of a pattern
+ *
+ */
+
+static void pattern_region(const configuration* pconfig, unsigned int ipattern,
+                           int rank, int proc_row, int proc_col, unsigned int k,
+                           unsigned int* step, unsigned int* array,
+                           partition* region)
+{
+  const unsigned int strong_scaling_flg =
+    (pconfig->scaling == SCALING_STRONG);
+  const unsigned long total_rows = strong_scaling_flg ?
+    pconfig->rows : pconfig->proc_rows*pconfig->rows;
+  const unsigned long total_cols = strong_scaling_flg ?
+    pconfig->cols : pconfig->proc_cols*pconfig->cols;
+  const uint64_t seed = mix64((uint64_t)pconfig->read_seed);
+
+  *step = k / pconfig->arrays;
+  *array = k % pconfig->arrays;
+
+  switch (ipattern)
+    {
+    case 1: /* time-series */
+      *step = k;
+      *array = pconfig->time_series_array;
+      get_partition(pconfig, proc_row, proc_col, region);
+      break;
+    case 2: /* sub-box */
+      get_partition(pconfig, proc_row, proc_col, region);
+      region->row0 += region->rows/2;
+      region->col0 += region->cols/2;
+      if (region->row0 + region->rows > total_rows)
+        region->row0 = total_rows - region->rows;
+      if (region->col0 + region->cols > total_cols)
+        region->col0 = total_cols - region->cols;
+      break;
+    case 3: /* random-tiles, the (step, array) stream is shared */
+      {
+        const uint64_t pair = mix64(seed ^ mix64(k)) %
+          ((uint64_t)pconfig->steps*pconfig->arrays);
+        const uint64_t tile = mix64(mix64(seed + (uint64_t)rank + 1) ^ mix64(k)) %
+          ((uint64_t)pconfig->proc_rows*pconfig->proc_cols);
+        *step = (unsigned int)(pair / pconfig->arrays);
+        *array = (unsigned int)(pair % pconfig->arrays);
+        get_partition(pconfig, (int)(tile / pconfig->proc_cols),
+                      (int)(tile % pconfig->proc_cols), region);
+      }
+      break;
+    default: /* broadcast */
+      get_partition(pconfig, 0, 0, region);
+      break;
+    }
+}
+
+void pattern_test
+(
+ configuration* pconfig,
+ const plan* pp,
+ char * hdf5_filename,
+ unsigned int ipattern,
+ int rank,
+ int my_proc_row,
+ int my_proc_col,
+ hid_t fapl,
+ hid_t dapl,
+ hid_t dxpl,
+ metrics* pm
+ )
+{
+  const unsigned int nreads = pattern_reads(pconfig, ipattern);
+  const double kernel = pm->kernel;
+  unsigned int k, step, array;
+  char path[255], open_path[255] = "";
+  partition region, largest;
+  hid_t file, dset = -1, fspace, mspace;
+  hsize_t dims[2];
+  double *rbuf, t;
+
+#ifdef VERIFY_DATA
+  /* Extent of the logical 4D array and region origin (see read_test.c) */
+  const unsigned int step_first_flg =
+    (pconfig->slowest_dimension == SLOWDIM_STEP);
+  const unsigned int strong_scaling_flg =
+    (pconfig->scaling == SCALING_STRONG);
+  size_t d[4], o[4], rows, cols;
+
+  d[0] = step_first_flg ? pconfig->steps : pconfig->arrays;
+  d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
+  d[2] = strong_scaling_flg ? pconfig->rows : pconfig->rows * pconfig->proc_rows;
+  d[3] = strong_scaling_flg ? pconfig->cols : pconfig->cols * pconfig->proc_cols;
+#endif
+
+  /* the first tile is the largest, and sub-boxes are tile-sized */
+  get_partition(pconfig, 0, 0, &largest);
+  rbuf = (double*) alloc_buffer(pconfig, largest.rows*largest.cols*pp->elem_size);
+  memset(rbuf, 0, largest.rows*largest.cols*pp->elem_size);
+
+  t = -MPI_Wtime();
+  assert((file = H5Fopen(hdf5_filename, H5F_ACC_RDONLY, fapl)) >= 0);
+
+  for (k = 0; k < nreads; ++k)
+    {
+      pattern_region(pconfig, ipattern, rank, my_proc_row, my_proc_col, k,
+                     &step, &array, &region);
+
+      dataset_path(pconfig, step, array, path);
+      if (strcmp(path, open_path) != 0)
+        {
+          if (dset >= 0)
+            assert(H5Dclose(dset) >= 0);
+          assert((dset = H5Dopen(file, path, dapl)) >= 0);
+          strcpy(open_path, path);
+        }
+
+      assert((fspace = H5Dget_space(dset)) >= 0);
+      select_region(pconfig, fspace, step, array, &region);
+      dims[0] = (hsize_t)region.rows;
+      dims[1] = (hsize_t)region.cols;
+      assert((mspace = H5Screate_simple(2, dims, NULL)) >= 0);
+
+      assert(H5Dread(dset, pp->mem_type, mspace, fspace, dxpl, rbuf) >= 0);
+      pm->pattern_bytes[ipattern] += (double)region.rows*region.cols*pp->elem_size;
+
+      assert(H5Sclose(mspace) >= 0);
+      assert(H5Sclose(fspace) >= 0);
+
+#ifdef VERIFY_DATA
+      o[0] = step_first_flg ? step : array;
+      o[1] = step_first_flg ? array : step;
+      o[2] = region.row0;
+      o[3] = region.col0;
+      rows = region.rows;
+      cols = region.cols;
+      verify_read_buffer(rbuf, &rows, &cols, d, o, pm);
+#endif
+    }
+
+  if (dset >= 0)
+    assert(H5Dclose(dset) >= 0);
+  assert(H5Fclose(file) >= 0);
+  t += MPI_Wtime();
+  /* verifying data is not I/O */
+  pm->pattern_time[ipattern] += t - (pm->kernel - kernel);
+
+  free(rbuf);
+}
@@ -0,0 +1,58 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef READ_PATTERNS_H
+#define READ_PATTERNS_H
+
+#include "configuration.h"
+#include "dataset.h"
+#include "metrics.h"
+#include "hdf5.h"
+
+/*
+ * Read patterns of analysis codes, run after the write decomposition was
+ * read back (same-as-write, see read_test.h):
+ *
+ *   time-series  - the rank's tile of a single array (time-series-array)
+ *                  for all steps
+ *   sub-box      - a tile-sized box, shifted by half a tile, i.e., across
+ *                  the tiles of up to four ranks, for all (step, array)
+ *   random-tiles - random-tiles reads of random tiles (seeded by read-seed);
+ *                  all ranks read the same random (step, array) at a time,
+ *                  which keeps collective reads collective
+ *   broadcast    - all ranks read the first tile, for all (step, array)
+ *
+ * Each rank issues the same number of reads, synchronously. With a file
+ * per process, only the rank's own tile is in the file, and only
+ * time-series applies.
+ */
+
+extern unsigned int pattern_applies(const configuration* pconfig,
+                                    unsigned int ipattern);
+
+extern void pattern_test
+(
+ configuration* pconfig,
+ const plan* pp,
+ char * hdf5_filename,
+ unsigned int ipattern,
+ int rank,
+ int my_proc_row,
+ int my_proc_col,
+ hid_t fapl,
+ hid_t dapl,
+ hid_t dxpl,
+ metrics* pm
+ );
+
+#endif
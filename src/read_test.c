@@ -14,30 +14,137 @@
 #include "read_test.h"
 
 #include "dataset.h"
+#include "instrument.h"
+#include "metrics.h"
+#include "threads.h"
+#include "utils.h"
 
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ *
+ * Timed wrapper for the read calls of the hot loop
+ *
+ */
+
+static void timed_read(const configuration* pconfig, const plan* pp,
+                       hid_t dset, hid_t mspace, hid_t fspace, hid_t dxpl,
+                       double* rbuf, time_step* es,
+                       double* read_time, metrics* pm)
+{
+  double t = -MPI_Wtime();
+#if H5_VERSION_GE(1,14,0)
+  if(es != NULL)
+    assert(H5Dread_async(dset, pp->mem_type, mspace, fspace, dxpl, rbuf, es->es_data) >= 0);
+  else
+#endif
+  if (pconfig->threads > 1) /* see threads.h */
+    threaded_transfer(pconfig, 0, dset, pp->mem_type, mspace, fspace, dxpl,
+                      rbuf, pm);
+  else
+    assert(H5Dread(dset, pp->mem_type, mspace, fspace, dxpl, rbuf) >= 0);
+  t += MPI_Wtime();
+  *read_time += t;
+  if (pm->read.count == 0) /* the latency to the first byte, see metrics.h */
+    {
+      pm->first_read = t;
+      pm->first_read_bytes = (double)H5Sget_select_npoints(mspace)*pp->elem_size;
+    }
+  hist_add(&pm->read, t);
+  pm->read_bytes += (double)H5Sget_select_npoints(mspace)*pp->elem_size;
+  if (es == NULL) /* the transfer properties are set on completion */
+    count_io_mode(dxpl, pm);
+}
+
+/* Open a dataset, asynchronously if an event set is given */
+static hid_t open_dataset(hid_t file, const char* path, hid_t dapl,
+                          time_step* es)
+{
+  hid_t result;
+#if H5_VERSION_GE(1,14,0)
+  if(es != NULL)
+    assert((result = H5Dopen_async(file, path, dapl, es->es_meta_open)) >= 0);
+  else
+#endif
+    assert((result = H5Dopen(file, path, dapl)) >= 0);
+  return result;
+}
+
+#if H5_VERSION_GE(1,14,0)
+/*
+ * Read the deferred tiles of all arrays of a step with a single
+ * multi-dataset call, and release their file spaces and datasets
+ */
+static void timed_read_multi(const plan* pp, size_t count, hid_t* dsets,
+                             hid_t mspace, hid_t* fspaces, const selection_cache* sc,
+                             hid_t dxpl, double** bufs,
+                             time_step* es, double* read_time, metrics* pm)
+{
+  hid_t *mem_types = (hid_t*) malloc(count*sizeof(hid_t));
+  hid_t *mspaces = (hid_t*) malloc(count*sizeof(hid_t));
+  size_t i;
+  double t;
+
+  for (i = 0; i < count; ++i)
+    {
+      mem_types[i] = pp->mem_type;
+      mspaces[i] = mspace;
+    }
+
+  t = -MPI_Wtime();
+  if(es != NULL)
+    assert(H5Dread_multi_async(count, dsets, mem_types, mspaces, fspaces, dxpl,
+                               (void**)bufs, es->es_data) >= 0);
+  else
+    assert(H5Dread_multi(count, dsets, mem_types, mspaces, fspaces, dxpl,
+                         (void**)bufs) >= 0);
+  t += MPI_Wtime();
+  *read_time += t;
+  if (pm->read.count == 0)
+    {
+      pm->first_read = t;
+      pm->first_read_bytes = (double)count*H5Sget_select_npoints(mspace)*pp->elem_size;
+    }
+  hist_add(&pm->read, t);
+  pm->read_bytes += (double)count*H5Sget_select_npoints(mspace)*pp->elem_size;
+  if (es == NULL)
+    count_io_mode(dxpl, pm);
+
+  for (i = 0; i < count; ++i)
+    {
+      release_tile(sc, fspaces[i]);
+      if(es != NULL)
+        assert(H5Dclose_async(dsets[i], es->es_meta_close) >= 0);
+      else
+        assert(H5Dclose(dsets[i]) >= 0);
+    }
+
+  free(mspaces);
+  free(mem_types);
+}
+#endif
+
 void read_test
 (
  configuration* pconfig,
  char * hdf5_filename,
  int size,
  int rank,
- int my_proc_row,
- int my_proc_col,
- unsigned long my_rows,
- unsigned long my_cols,
+ const plan* pp,
  hid_t fapl,
  hid_t dapl,
  hid_t dxpl,
+ step_log* plog,
  double* create_time,
- double* read_time
+ double* read_time,
+ metrics* pm
  )
 {
-  unsigned int step_first_flg, strong_scaling_flg;
+  const unsigned long my_rows = pp->tile.rows, my_cols = pp->tile.cols;
+  unsigned int step_first_flg;
   unsigned int istep, iarray;
   double *rbuf;
   hid_t mspace;
@@ -46,10 +153,20 @@ void read_test
 
   hid_t file, dset, fspace;
 
+  /* deferred datasets, file spaces, and buffers for multi-dataset reads */
+  hid_t *mdset = NULL, *mfspace = NULL;
+  double **mbuf = NULL;
+
   time_step *es = NULL;
+#if H5_VERSION_GE(1,14,0)
+  hid_t     es_file;
+#endif
   size_t    num_in_progress;
   hbool_t   op_failed;
 
+  /* file space selection templates */
+  selection_cache sc;
+
 #ifdef VERIFY_DATA
   /* Extent of the logical 4D array and partition origin/offset */
   size_t d[4], o[4];
@@ -63,9 +180,23 @@ void read_test
    */
 #endif
 
-  step_first_flg = (strncmp(pconfig->slowest_dimension, "step", 16) == 0);
-
-  rbuf = (double*) calloc(my_rows*my_cols, sizeof(double));
+  step_first_flg = pp->step_first_flg;
+
+  if (pconfig->multi_dataset)
+    { /* the arrays of a step are read together into distinct tiles */
+      rbuf = (double*) alloc_buffer(pconfig, pconfig->arrays*pp->tile_words*sizeof(double));
+      memset(rbuf, 0, pconfig->arrays*pp->tile_words*sizeof(double));
+      mdset = (hid_t*) malloc(pconfig->arrays*sizeof(hid_t));
+      mfspace = (hid_t*) malloc(pconfig->arrays*sizeof(hid_t));
+      mbuf = (double**) malloc(pconfig->arrays*sizeof(double*));
+      for (iarray = 0; iarray < pconfig->arrays; ++iarray)
+        mbuf[iarray] = rbuf + iarray*pp->tile_words;
+    }
+  else
+    {
+      rbuf = (double*) alloc_buffer(pconfig, pp->tile_words*sizeof(double));
+      memset(rbuf, 0, pp->tile_words*sizeof(double));
+    }
   { /* create the in-memory dataspace */
     hsize_t dims[2];
     dims[0] = (hsize_t)my_rows;
@@ -75,71 +206,63 @@ void read_test
   }
 
 #ifdef VERIFY_DATA
-  strong_scaling_flg = (strncmp(pconfig->scaling, "strong", 16) == 0);
-
-  d[2] = strong_scaling_flg ? pconfig->rows : pconfig->rows * pconfig->proc_rows;
-  d[3] = strong_scaling_flg ? pconfig->cols : pconfig->cols * pconfig->proc_cols;
-
-  o[2] = strong_scaling_flg ? rank * my_rows : my_proc_row * pconfig->rows;
-  o[3] = strong_scaling_flg ? rank * my_cols : my_proc_col * pconfig->cols;
+  d[2] = pp->total_rows;
+  d[3] = pp->total_cols;
+  /* the tile's origin */
+  o[2] = pp->tile.row0;
+  o[3] = pp->tile.col0;
   if (rank == 0)
-    printf("\n\033[1;31m WARNING: Data verification enabled. Timings will be distorted!!!\033[0m\n");
+    printf("\n\033[1;31m WARNING: Data verification enabled. Generating and verifying data is\n"
+           " excluded from the timings, but the caches will be colder!\033[0m\n");
 #endif
 
 #if H5_VERSION_GE(1,14,0)
   if (pconfig->async == 1) {
-    es    = calloc(1, sizeof(time_step));
-    es->es_data      = H5EScreate();
-    es->es_meta_data = H5EScreate();
+    es = create_event_sets(1);
+    assert((es_file = H5EScreate()) >= 0);
   }
 #endif
 
+  pm->read_open = -MPI_Wtime();
 #if H5_VERSION_GE(1,14,0)
   if(es != NULL)
-    assert((file = H5Fopen_async(hdf5_filename, H5F_ACC_RDONLY, fapl, 0)) >= 0);
+    assert((file = H5Fopen_async(hdf5_filename, H5F_ACC_RDONLY, fapl, es_file)) >= 0);
   else
 #endif
     assert((file = H5Fopen(hdf5_filename, H5F_ACC_RDONLY, fapl)) >= 0);
+  pm->read_open += MPI_Wtime();
   
+  /* with selection caching, the selection is built only once per case */
+  *create_time -= MPI_Wtime();
+  create_selection_cache(pconfig, &pp->tile, &sc);
+  *create_time += MPI_Wtime();
+
   switch (pconfig->rank)
     {
     case 4:
       {
-#if H5_VERSION_GE(1,14,0)
-        if(es != NULL)
-          assert((dset = H5Dopen_async(file, "dataset", dapl, es->es_meta_data)) >= 0);
-        else
-#endif
-        assert((dset = H5Dopen(file, "dataset", dapl)) >= 0);
+        dset = open_dataset(file, "dataset", dapl, es);
 
         for (istep = 0; istep < pconfig->steps; ++istep)
           {
             for (iarray = 0; iarray < pconfig->arrays; ++iarray)
               {
-                assert((fspace = H5Dget_space(dset)) >= 0);
-                *create_time -= MPI_Wtime();
-                create_selection(pconfig, fspace, my_proc_row, my_proc_col,
-                                 istep, iarray);
-                *create_time += MPI_Wtime();
-                *read_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                if(es != NULL)
-                  assert(H5Dread_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf, es->es_data) >= 0);
-                else
-#endif
-                  assert(H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf) >= 0);
-                *read_time += MPI_Wtime();
-                assert(H5Sclose(fspace) >= 0);
+                fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                     istep, iarray, create_time, pm);
+                timed_read(pconfig, pp, dset, mspace, fspace, dxpl, rbuf, es, read_time, pm);
+                release_tile(&sc, fspace);
 
 #ifdef VERIFY_DATA
                 d[0] = step_first_flg ? pconfig->steps : pconfig->arrays;
                 d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
                 o[0] = step_first_flg ? istep : iarray;
                 o[1] = step_first_flg ? iarray : istep;
-                verify_read_buffer(rbuf, &my_rows, &my_cols, d, o);
+                verify_read_buffer(rbuf, &my_rows, &my_cols, d, o, pm);
 #endif
               }
 
+            log_step(plog, istep, *read_time);
+
             /* Simulate the compute phase */
             if (pconfig->delay.enable == 1) {
               if (istep != pconfig->steps - 1) { // no sleep after the last es
@@ -159,7 +282,7 @@ void read_test
           }
 #if H5_VERSION_GE(1,14,0)
         if(es != NULL)
-          assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+          assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
         else
 #endif
           assert(H5Dclose(dset) >= 0);
@@ -172,41 +295,33 @@ void read_test
           {
             for (istep = 0; istep < pconfig->steps; ++istep)
               {
-                sprintf(path, "step=%d", istep);
-                assert((dset = H5Dopen(file, path, dapl)) >= 0);
-                assert((fspace = H5Dget_space(dset)) >= 0);
+                dataset_path(pconfig, istep, 0, path);
+                dset = open_dataset(file, path, dapl, es);
 
                 for (iarray = 0; iarray < pconfig->arrays; ++iarray)
                   {
-                    *create_time -= MPI_Wtime();
-                    create_selection(pconfig, fspace, my_proc_row,
-                                     my_proc_col, istep, iarray);
-                    *create_time += MPI_Wtime();
+                    fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                         istep, iarray, create_time, pm);
 
-                    *read_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                    if(es != NULL)
-                      assert(H5Dread_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf, es->es_data) >= 0);
-                    else
-#endif
-                      assert(H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf) >= 0);
-                    *read_time += MPI_Wtime();
+                    timed_read(pconfig, pp, dset, mspace, fspace, dxpl, rbuf, es, read_time, pm);
+                    release_tile(&sc, fspace);
 
 #ifdef VERIFY_DATA
                     d[0] = pconfig->steps; d[1] = pconfig->arrays;
                     o[0] = istep; o[1] = iarray;
-                    verify_read_buffer(rbuf, &my_rows, &my_cols, d, o);
+                    verify_read_buffer(rbuf, &my_rows, &my_cols, d, o, pm);
 #endif
                   }
 
-                assert(H5Sclose(fspace) >= 0);
 #if H5_VERSION_GE(1,14,0)
                 if(es != NULL)
-                  assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                  assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                 else
 #endif
                   assert(H5Dclose(dset) >= 0);
 
+                log_step(plog, istep, *read_time);
+
                 if (pconfig->delay.enable == 1) {
                   if (istep != pconfig->steps - 1) { // no sleep after the last es
                     if (rank == 0)
@@ -229,27 +344,24 @@ void read_test
               {
                 for (iarray = 0; iarray < pconfig->arrays; ++iarray)
                   {
-                    sprintf(path, "array=%d", iarray);
-                    assert((dset = H5Dopen(file, path, dapl)) >= 0);
-                    assert((fspace = H5Dget_space(dset)) >= 0);
-                    *create_time -= MPI_Wtime();
-                    create_selection(pconfig, fspace, my_proc_row,
-                                     my_proc_col, istep, iarray);
-                    *create_time += MPI_Wtime();
-
-                    *read_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                    if(es != NULL)
-                      assert(H5Dread_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf, es->es_data) >= 0);
-                    else
-#endif
-                      assert(H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf) >= 0);
-                    *read_time += MPI_Wtime();
+                    dataset_path(pconfig, 0, iarray, path);
+                    dset = open_dataset(file, path, dapl, es);
+                    fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                         istep, iarray, create_time, pm);
 
-                    assert(H5Sclose(fspace) >= 0);
+                    if (pconfig->multi_dataset)
+                      { /* defer the read to a single call per step */
+                        mdset[iarray] = dset;
+                        mfspace[iarray] = fspace;
+                        continue;
+                      }
+
+                    timed_read(pconfig, pp, dset, mspace, fspace, dxpl, rbuf, es, read_time, pm);
+
+                    release_tile(&sc, fspace);
 #if H5_VERSION_GE(1,14,0)
                     if(es != NULL)
-                      assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                      assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                     else
 #endif
                       assert(H5Dclose(dset) >= 0);
@@ -257,9 +369,26 @@ void read_test
 #ifdef VERIFY_DATA
                     d[0] = pconfig->arrays; d[1] = pconfig->steps;
                     o[0] = iarray; o[1] = istep;
-                    verify_read_buffer(rbuf, &my_rows, &my_cols, d, o);
+                    verify_read_buffer(rbuf, &my_rows, &my_cols, d, o, pm);
+#endif
+                  }
+#if H5_VERSION_GE(1,14,0)
+                if (pconfig->multi_dataset)
+                  {
+                    timed_read_multi(pp, pconfig->arrays, mdset, mspace, mfspace, &sc, dxpl,
+                                     mbuf, es, read_time, pm);
+#ifdef VERIFY_DATA
+                    for (iarray = 0; iarray < pconfig->arrays; ++iarray)
+                      {
+                        d[0] = pconfig->arrays; d[1] = pconfig->steps;
+                        o[0] = iarray; o[1] = istep;
+                        verify_read_buffer(mbuf[iarray], &my_rows, &my_cols, d, o, pm);
+                      }
 #endif
                   }
+#endif
+
+                log_step(plog, istep, *read_time);
 
                 if (pconfig->delay.enable == 1) {
                   if (istep != pconfig->steps - 1) { // no sleep after the last es
@@ -286,32 +415,26 @@ void read_test
             for (iarray = 0; iarray < pconfig->arrays; ++iarray)
               {
                 /* group per step or array */
-                sprintf(path, (step_first_flg ?
-                               "step=%d/array=%d" : "array=%d/step=%d"),
-                        (step_first_flg ? istep : iarray),
-                        (step_first_flg ? iarray : istep));
+                dataset_path(pconfig, istep, iarray, path);
 
-                assert((dset = H5Dopen(file, path, dapl)) >= 0);
+                dset = open_dataset(file, path, dapl, es);
 
-                assert((fspace = H5Dget_space(dset)) >= 0);
-                *create_time -= MPI_Wtime();
-                create_selection(pconfig, fspace, my_proc_row, my_proc_col,
-                                 istep, iarray);
-                *create_time += MPI_Wtime();
+                fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                     istep, iarray, create_time, pm);
 
-                *read_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                if(es != NULL)
-                  assert(H5Dread_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf, es->es_data) >= 0);
-                else
-#endif
-                  assert(H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, rbuf) >= 0);
-                *read_time += MPI_Wtime();
+                if (pconfig->multi_dataset)
+                  { /* defer the read to a single call per step */
+                    mdset[iarray] = dset;
+                    mfspace[iarray] = fspace;
+                    continue;
+                  }
 
-                assert(H5Sclose(fspace) >= 0);
+                timed_read(pconfig, pp, dset, mspace, fspace, dxpl, rbuf, es, read_time, pm);
+
+                release_tile(&sc, fspace);
 #if H5_VERSION_GE(1,14,0)
                 if(es != NULL)
-                  assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                  assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                 else
 #endif
                   assert(H5Dclose(dset) >= 0);
@@ -321,9 +444,28 @@ void read_test
                 d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
                 o[0] = step_first_flg ? istep : iarray;
                 o[1] = step_first_flg ? iarray : istep;
-                verify_read_buffer(rbuf, &my_rows, &my_cols, d, o);
+                verify_read_buffer(rbuf, &my_rows, &my_cols, d, o, pm);
 #endif
               }
+#if H5_VERSION_GE(1,14,0)
+            if (pconfig->multi_dataset)
+              {
+                timed_read_multi(pp, pconfig->arrays, mdset, mspace, mfspace, &sc, dxpl,
+                                 mbuf, es, read_time, pm);
+#ifdef VERIFY_DATA
+                for (iarray = 0; iarray < pconfig->arrays; ++iarray)
+                  {
+                    d[0] = step_first_flg ? pconfig->steps : pconfig->arrays;
+                    d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
+                    o[0] = step_first_flg ? istep : iarray;
+                    o[1] = step_first_flg ? iarray : istep;
+                    verify_read_buffer(mbuf[iarray], &my_rows, &my_cols, d, o, pm);
+                  }
+#endif
+              }
+#endif
+
+            log_step(plog, istep, *read_time);
 
             if (pconfig->delay.enable == 1) {
               if (istep != pconfig->steps - 1) { // no sleep after the last es
@@ -348,17 +490,23 @@ void read_test
 
 #if H5_VERSION_GE(1,14,0)
   if(es != NULL) {
-    if (pconfig->async == 1) {
-      H5ESwait(es->es_meta_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
-      H5ESclose(es->es_meta_data);
-      H5ESclose(es->es_data);
-    }
-    assert(H5Fclose_async(file, 0) >= 0);
-    free(es);
+    H5ESwait(es->es_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
+    drain_metadata_event_sets(es, pm);
+    assert(H5Fclose_async(file, es_file) >= 0);
+    pm->drain_file += drain_event_set(es_file);
+    assert(H5ESclose(es_file) >= 0);
+    close_event_sets(es, 1);
   } else
 #endif
     assert(H5Fclose(file) >= 0);
 
   assert(H5Sclose(mspace) >= 0);
+  close_selection_cache(&sc);
+  if (pconfig->multi_dataset)
+    {
+      free(mbuf);
+      free(mfspace);
+      free(mdset);
+    }
   free(rbuf);
 }
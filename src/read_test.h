@@ -15,6 +15,9 @@
 #define READ_TEST_H
 
 #include "configuration.h"
+#include "dataset.h"
+#include "metrics.h"
+#include "step_log.h"
 #include "hdf5.h"
 
 extern void read_test
@@ -23,15 +26,14 @@ extern void read_test
  char * hdf5_filename,
  int size,
  int rank,
- int my_proc_row,
- int my_proc_col,
- unsigned long my_rows,
- unsigned long my_cols,
+ const plan* pp,
  hid_t fapl,
  hid_t dapl,
  hid_t dxpl,
+ step_log* plog,
  double* create_time,
- double* read_time
+ double* read_time,
+ metrics* pm
  );
 
 #endif
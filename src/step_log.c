@@ -0,0 +1,103 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "step_log.h"
+
+#include <assert.h>
+#include <string.h>
+
+void open_step_log(const char* fname, int restart_flg, step_log* pl)
+{
+  memset(pl, 0, sizeof(step_log));
+  MPI_Comm_rank(MPI_COMM_WORLD, &pl->rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &pl->size);
+
+  if (pl->rank == 0)
+    {
+      pl->fptr = fopen(fname, restart_flg ? "a" : "w");
+      assert(pl->fptr != NULL);
+      if (!restart_flg)
+        fprintf(pl->fptr, "case,repetition,case-key,phase,step,min [s],max [s],avg [s]\n");
+      fflush(pl->fptr);
+    }
+}
+
+void begin_step_phase(step_log* pl, unsigned int icase,
+                      unsigned int irep, const char* case_key,
+                      const char* phase)
+{
+  pl->icase = icase;
+  pl->irep = irep;
+  pl->case_key = case_key;
+  pl->phase = phase;
+  pl->mark = 0.0;
+  pl->next = 0;
+}
+
+/* Wait for a record's reductions and write it out */
+
+static void complete(step_log* pl, step_record* pr)
+{
+  if (!pr->busy)
+    return;
+
+  MPI_Waitall(2, pr->req, MPI_STATUSES_IGNORE);
+  pr->busy = 0;
+  if (pl->rank == 0)
+    {
+      fprintf(pl->fptr, "%u,%u,%s,%s,%u,%.6f,%.6f,%.6f\n", pl->icase,
+              pl->irep, pl->case_key, pl->phase, pr->step, -pr->minmax[1],
+              pr->minmax[0], pr->sum/pl->size);
+      fflush(pl->fptr);
+    }
+}
+
+void log_step(step_log* pl, unsigned int step, double total)
+{
+  step_record* pr;
+
+  if (pl == NULL)
+    return;
+
+  pr = &pl->ring[pl->next];
+  pl->next = (pl->next + 1) % STEP_LOG_RING;
+  complete(pl, pr);
+
+  pr->step = step;
+  pr->send[0] = total - pl->mark;
+  pr->send[1] = -pr->send[0];
+  pr->send[2] = pr->send[0];
+  pl->mark = total;
+
+  MPI_Ireduce(pr->send, pr->minmax, 2, MPI_DOUBLE, MPI_MAX, 0,
+              MPI_COMM_WORLD, &pr->req[0]);
+  MPI_Ireduce(pr->send + 2, &pr->sum, 1, MPI_DOUBLE, MPI_SUM, 0,
+              MPI_COMM_WORLD, &pr->req[1]);
+  pr->busy = 1;
+}
+
+void end_step_phase(step_log* pl)
+{
+  unsigned int i;
+
+  /* in the order of the steps */
+  for (i = 0; i < STEP_LOG_RING; ++i)
+    complete(pl, &pl->ring[(pl->next + i) % STEP_LOG_RING]);
+}
+
+void close_step_log(step_log* pl)
+{
+  if (pl->rank == 0)
+    fclose(pl->fptr);
+  pl->fptr = NULL;
+}
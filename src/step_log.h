@@ -0,0 +1,76 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef STEP_LOG_H
+#define STEP_LOG_H
+
+#include "mpi.h"
+
+#include <stdio.h>
+
+/*
+ * Per-step time series. At the end of each step of the write and read
+ * phases, the ranks' I/O time of the step is reduced (min, max, avg) with
+ * nonblocking MPI_Ireduce, i.e., without adding a barrier. A ring of
+ * STEP_LOG_RING reductions is in flight; rank 0 appends a record to the
+ * sidecar CSV file whenever a slot is reused and at the end of a phase,
+ * so the file grows while the case runs.
+ *
+ * All ranks must log the same steps of the same phases.
+ */
+
+#define STEP_LOG_RING 8
+
+typedef struct
+{
+  MPI_Request  req[2];
+  double       send[3];      /* t, -t, t */
+  double       minmax[2];    /* max, -min (rank 0) */
+  double       sum;          /* (rank 0) */
+  unsigned int step;
+  unsigned int busy;
+} step_record;
+
+typedef struct
+{
+  FILE*        fptr;         /* rank 0 */
+  int          rank, size;
+  unsigned int icase;
+  unsigned int irep;         /* warmups first */
+  const char*  case_key;
+  const char*  phase;
+  double       mark;         /* cumulative I/O time at the previous step */
+  unsigned int next;
+  step_record  ring[STEP_LOG_RING];
+} step_log;
+
+/* Create (or, when restarting, append to) the sidecar file (collective) */
+
+extern void open_step_log(const char* fname, int restart_flg, step_log* pl);
+
+extern void begin_step_phase(step_log* pl, unsigned int icase,
+                             unsigned int irep, const char* case_key,
+                             const char* phase);
+
+/* Record a step, given the phase's cumulative I/O time so far (collective,
+   but nonblocking); pl can be NULL */
+
+extern void log_step(step_log* pl, unsigned int step, double total);
+
+/* Complete the reductions of the phase (collective) */
+
+extern void end_step_phase(step_log* pl);
+
+extern void close_step_log(step_log* pl);
+
+#endif
@@ -0,0 +1,698 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "sweep.h"
+#include "object_store.h"
+#include "threads.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* fmt_low[2]  = { "earliest", "latest" };
+static const char* mpi_mod[2]  = { "independent", "collective" };
+static const char* on_off[2]   = { "0", "1" };
+
+#define CTX ((sweep*)ctx)
+
+/* Is the file accessed through the MPI-IO VFD? */
+
+static int mpio_flg(const sweep* psw)
+{
+  return (psw->size > 1 ||
+          strncmp(psw->requested.single_process, "mpi-io-uni", 16) == 0);
+}
+
+/* ========================================================================== */
+/* dataset rank */
+
+static void rank_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%u", i + 2);
+}
+
+static int rank_apply(void* ctx, unsigned int i)
+{
+  CTX->pconfig->rank = i + 2;
+  return 1;
+}
+
+/* ========================================================================== */
+/* slowest changing dimension */
+
+static void slowdim_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", slowdim_names[i]);
+}
+
+static int slowdim_apply(void* ctx, unsigned int i)
+{
+  CTX->pconfig->slowest_dimension = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* dataset layout */
+
+static void layout_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", layout_names[i]);
+}
+
+static int layout_apply(void* ctx, unsigned int i)
+{
+  CTX->pconfig->layout = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* chunk shape */
+
+static void chunk_scale_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  char cscale[32];
+  format_chunk_scale(CTX->requested.chunk_scales[i], cscale);
+  snprintf(buf, len, "%s", cscale);
+}
+
+static int chunk_scale_apply(void* ctx, unsigned int i)
+{
+  /* only the first value matters for the contiguous layout */
+  if (i > 0 && CTX->pconfig->layout == LAYOUT_CONTIGUOUS)
+    return 0;
+  CTX->pconfig->chunk_scale[0] = CTX->requested.chunk_scales[i][0];
+  CTX->pconfig->chunk_scale[1] = CTX->requested.chunk_scales[i][1];
+  return 1;
+}
+
+/* ========================================================================== */
+/* chunk cache */
+
+static void chunk_cache_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  char ccache[64];
+  format_chunk_cache(&CTX->requested.chunk_caches[i], ccache);
+  snprintf(buf, len, "%s", ccache);
+}
+
+static int chunk_cache_apply(void* ctx, unsigned int i)
+{
+  if (i > 0 && CTX->pconfig->layout == LAYOUT_CONTIGUOUS)
+    return 0;
+  CTX->pconfig->cache = CTX->requested.chunk_caches[i];
+  assert(H5Pset_chunk_cache(CTX->dapl, CTX->pconfig->cache.nslots,
+                            CTX->pconfig->cache.nbytes,
+                            CTX->pconfig->cache.w0) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* dataset filter */
+
+static void compression_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", CTX->requested.compressions[i].label);
+}
+
+static int compression_apply(void* ctx, unsigned int i)
+{
+  /* there are no filters for the contiguous layout */
+  if (i > 0 && CTX->pconfig->layout == LAYOUT_CONTIGUOUS)
+    return 0;
+  CTX->pconfig->compression = CTX->requested.compressions[i];
+  return 1;
+}
+
+/* ========================================================================== */
+/* write fill values */
+
+static void fill_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", fill_names[i]);
+}
+
+static int fill_apply(void* ctx, unsigned int i)
+{
+  CTX->pconfig->fill_values = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* alignment, the baseline first */
+
+/* The direct VFD needs file addresses aligned like the buffers, so the
+   increment is rounded up to a multiple of the buffer alignment */
+
+static hsize_t alignment_increment(const sweep* psw, unsigned int i)
+{
+  hsize_t incr = (i == 0) ? 1 : psw->requested.alignment_increment;
+  hsize_t align = (hsize_t) psw->requested.buffer_alignment;
+
+  if (psw->size == 1 &&
+      strncmp(psw->requested.single_process, "direct", 16) == 0)
+    incr = ((incr + align - 1)/align)*align;
+  return incr;
+}
+
+static void alignment_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%llu:%llu",
+           (unsigned long long)alignment_increment(CTX, i),
+           (i == 0) ? 0ULL :
+           (unsigned long long)CTX->requested.alignment_threshold);
+}
+
+static int alignment_apply(void* ctx, unsigned int i)
+{
+  /* check if we need to run anything beyond the baseline */
+  if (i > 0 && alignment_increment(CTX, 1) == alignment_increment(CTX, 0) &&
+      CTX->requested.alignment_threshold == 0)
+    return 0;
+  CTX->pconfig->alignment_increment = alignment_increment(CTX, i);
+  CTX->pconfig->alignment_threshold = (i == 0) ? 0 :
+    CTX->requested.alignment_threshold;
+  assert(H5Pset_alignment(CTX->fapl, CTX->pconfig->alignment_threshold,
+                          CTX->pconfig->alignment_increment) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* meta block size, the baseline first */
+
+static void mblk_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%llu", (i == 0) ? 2048ULL :
+           (unsigned long long)CTX->requested.meta_block_size);
+}
+
+static int mblk_apply(void* ctx, unsigned int i)
+{
+  if (i > 0 && CTX->requested.meta_block_size == 2048)
+    return 0;
+  CTX->pconfig->meta_block_size = (i == 0) ? 2048 :
+    CTX->requested.meta_block_size;
+  assert(H5Pset_meta_block_size(CTX->fapl, CTX->pconfig->meta_block_size) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* file space strategy */
+
+static void fspace_strategy_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", fspace_strategy_names[i]);
+}
+
+static int fspace_strategy_apply(void* ctx, unsigned int i)
+{
+  if ((CTX->requested.fspace_strategies & (1u << i)) == 0)
+    return 0;
+  CTX->pconfig->fspace_strategy = i;
+  assert(H5Pset_file_space_strategy(CTX->fcpl, (H5F_fspace_strategy_t)i,
+                                    0, (hsize_t)1) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* file space page size */
+
+static void page_size_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%llu", (unsigned long long)CTX->requested.page_sizes[i]);
+}
+
+static int page_size_apply(void* ctx, unsigned int i)
+{
+  /* only the first value matters without paged aggregation */
+  if (i > 0 && CTX->pconfig->fspace_strategy != H5F_FSPACE_STRATEGY_PAGE)
+    return 0;
+  CTX->pconfig->page_size = CTX->requested.page_sizes[i];
+  assert(H5Pset_file_space_page_size(CTX->fcpl, CTX->pconfig->page_size) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* metadata cache */
+
+static void mdc_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  char mdc[64];
+  format_mdc_config(&CTX->requested.mdc_configs[i], mdc);
+  snprintf(buf, len, "%s", mdc);
+}
+
+static int mdc_apply(void* ctx, unsigned int i)
+{
+  const mdc_config* pc = &CTX->requested.mdc_configs[i];
+  H5AC_cache_config_t mdc = CTX->mdc_default;
+
+  if (pc->initial_size > 0)
+    {
+      mdc.set_initial_size = 1;
+      mdc.initial_size = pc->initial_size;
+      mdc.max_size = pc->max_size;
+      if (mdc.min_size > mdc.initial_size)
+        mdc.min_size = mdc.initial_size;
+      if (!pc->evictions)
+        { /* the cache must not be resized without evictions */
+          mdc.evictions_enabled = 0;
+          mdc.incr_mode = H5C_incr__off;
+          mdc.flash_incr_mode = H5C_flash_incr__off;
+          mdc.decr_mode = H5C_decr__off;
+        }
+    }
+  CTX->pconfig->mdc = *pc;
+  assert(H5Pset_mdc_config(CTX->fapl, &mdc) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* lower libver bound */
+
+static void fmt_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", fmt_low[i]);
+}
+
+static int fmt_apply(void* ctx, unsigned int i)
+{
+  strncpy(CTX->pconfig->libver_bound_low, fmt_low[i],
+          sizeof(CTX->pconfig->libver_bound_low));
+  assert(set_libver_bounds(CTX->pconfig, CTX->rank, CTX->fapl) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* multi-dataset I/O */
+
+static void on_off_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", on_off[i]);
+}
+
+static int multi_apply(void* ctx, unsigned int i)
+{
+  /* run the baseline first, and the multi-dataset variant only if requested
+     for rank-2 and "dataset per array" rank-3 layouts, which write more
+     than one dataset per step */
+  if (i == 1 && (CTX->requested.multi_dataset == 0 ||
+                 CTX->pconfig->rank == 4 ||
+                 (CTX->pconfig->rank == 3 &&
+                  CTX->pconfig->slowest_dimension == SLOWDIM_STEP)))
+    return 0;
+  CTX->pconfig->multi_dataset = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* appending (extendible datasets) */
+
+static int append_apply(void* ctx, unsigned int i)
+{
+  /* run the baseline first, and the appending variant only if requested
+     for the layouts with an unlimited step dimension, i.e., chunked rank-4
+     and "dataset per array" rank-3 datasets */
+  if (i == 1 && (CTX->requested.append == 0 ||
+                 CTX->pconfig->layout != LAYOUT_CHUNKED ||
+                 CTX->pconfig->rank == 2 ||
+                 (CTX->pconfig->rank == 3 &&
+                  CTX->pconfig->slowest_dimension == SLOWDIM_STEP)))
+    return 0;
+  CTX->pconfig->append = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* selection caching */
+
+static int selection_cache_apply(void* ctx, unsigned int i)
+{
+  /* run the baseline first, and with cached selections only if requested */
+  if (i == 1 && CTX->requested.selection_cache == 0)
+    return 0;
+  CTX->pconfig->selection_cache = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* pre-created datasets */
+
+static int precreate_apply(void* ctx, unsigned int i)
+{
+  /* run the baseline first, and with pre-created datasets only if requested
+     for the layouts with more than one dataset */
+  if (i == 1 && (CTX->requested.precreate == 0 || CTX->pconfig->rank == 4))
+    return 0;
+  CTX->pconfig->precreate = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* file mode */
+
+static void file_mode_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", file_mode_names[i]);
+}
+
+static int file_mode_apply(void* ctx, unsigned int i)
+{
+  /* only the requested modes, and the split driver needs a shared file */
+  if ((CTX->requested.file_modes & (1u << i)) == 0 ||
+      (i != FILE_MODE_SHARED && CTX->requested.split == 1))
+    return 0;
+  CTX->pconfig->file_mode = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* page buffer */
+
+static void page_buffer_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  char pbuf[64];
+  format_page_buffer(&CTX->requested.page_buffers[i], pbuf);
+  snprintf(buf, len, "%s", pbuf);
+}
+
+static int page_buffer_apply(void* ctx, unsigned int i)
+{
+  const page_buffer* pb = &CTX->requested.page_buffers[i];
+  /* the page buffer needs paged aggregation and at least one page, and
+     HDF5 doesn't support it with parallel access or through the split
+     driver, i.e., only for a sec2/core/direct file of its own */
+  if (pb->size > 0 &&
+      (CTX->pconfig->fspace_strategy != H5F_FSPACE_STRATEGY_PAGE ||
+       pb->size < CTX->pconfig->page_size || CTX->requested.split == 1 ||
+       CTX->pconfig->file_mode == FILE_MODE_SUBFILING ||
+       (CTX->pconfig->file_mode == FILE_MODE_SHARED && mpio_flg(CTX))))
+    return 0;
+  CTX->pconfig->pbuf = *pb;
+  assert(H5Pset_page_buffer_size(CTX->fapl, pb->size, pb->min_meta_perc,
+                                 pb->min_raw_perc) >= 0);
+  return 1;
+}
+
+/* ========================================================================== */
+/* collective metadata operations */
+
+static int coll_metadata_apply(void* ctx, unsigned int i)
+{
+  unsigned int modes = CTX->requested.coll_metadata_modes;
+
+  if ((modes & (1u << i)) == 0)
+    return 0;
+  /* they only matter for a file shared through the MPI-IO VFD, otherwise
+     run the first requested mode only */
+  if (!mpio_flg(CTX) || CTX->pconfig->file_mode == FILE_MODE_PER_PROCESS)
+    {
+      if (i == 1 && (modes & 1u))
+        return 0;
+    }
+  else
+    {
+      assert(H5Pset_all_coll_metadata_ops(CTX->fapl, i) >= 0);
+      assert(H5Pset_coll_metadata_write(CTX->fapl, i) >= 0);
+    }
+  CTX->pconfig->coll_metadata = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* MPI-IO hints (the cross product of all listed values) */
+
+static void hints_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  const configuration* pconfig = &CTX->requested;
+  unsigned int k, ivalue;
+  size_t n = 0;
+
+  snprintf(buf, len, "none");
+  for (k = 0; k < pconfig->nhints && n < len; ++k)
+    { /* the first hint varies fastest, as in select_hints() */
+      ivalue = i % pconfig->hints[k].nvalues;
+      i /= pconfig->hints[k].nvalues;
+      n += snprintf(buf + n, len - n, "%s%s=%s", (k > 0) ? ";" : "",
+                    pconfig->hints[k].key, pconfig->hints[k].values[ivalue]);
+    }
+}
+
+static int hints_apply(void* ctx, unsigned int i)
+{
+  MPI_Info info;
+  /* hints only matter for a file shared through the MPI-IO VFD */
+  if (i > 0 && (!mpio_flg(CTX) || CTX->pconfig->file_mode != FILE_MODE_SHARED))
+    return 0;
+  info = select_hints(CTX->pconfig, i);
+  if (mpio_flg(CTX))
+    assert(H5Pset_fapl_mpio(CTX->fapl, MPI_COMM_WORLD, info) >= 0);
+  if (!mpio_flg(CTX) || CTX->pconfig->file_mode != FILE_MODE_SHARED)
+    strcpy(CTX->pconfig->hints_requested, "none");  /* they don't reach the file */
+  if (info != MPI_INFO_NULL)
+    MPI_Info_free(&info);
+  return 1;
+}
+
+/* ========================================================================== */
+/* MPI-IO mode */
+
+static void io_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", (CTX->size > 1) ? mpi_mod[i] :
+           CTX->requested.single_process);
+}
+
+static int io_apply(void* ctx, unsigned int i)
+{
+  configuration* pconfig = CTX->pconfig;
+
+  if (CTX->size > 1)
+    {
+      /* there is no collective I/O across separate files, and the split
+         driver can't do collective I/O */
+      if (i == 1 &&
+          (pconfig->file_mode == FILE_MODE_PER_PROCESS || pconfig->split == 1))
+        return 0;
+      strncpy(pconfig->mpi_io, mpi_mod[i], sizeof(pconfig->mpi_io)-1);
+      CTX->coll_mpi_io_flg = i;
+      assert(H5Pset_dxpl_mpio(CTX->dxpl, CTX->coll_mpi_io_flg ?
+                              H5FD_MPIO_COLLECTIVE :
+                              H5FD_MPIO_INDEPENDENT) >= 0);
+    }
+  else
+    {
+      CTX->coll_mpi_io_flg = 0;
+      if (strncmp(pconfig->single_process, "mpi-io-uni", 16) == 0 &&
+          pconfig->compression.id != H5Z_FILTER_NONE)
+        {
+          assert(H5Pset_dxpl_mpio(CTX->dxpl, H5FD_MPIO_COLLECTIVE) >= 0);
+          CTX->coll_mpi_io_flg = 1;
+        }
+      strncpy(pconfig->mpi_io, pconfig->single_process, sizeof(pconfig->mpi_io));
+    }
+  return 1;
+}
+
+/* ========================================================================== */
+/* read mode */
+
+static void read_mode_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", read_mode_names[i]);
+}
+
+static int read_mode_apply(void* ctx, unsigned int i)
+{
+  if ((CTX->requested.read_modes & (1u << i)) == 0)
+    return 0;
+  /* ros3 reads a single file, not the split driver's pair or subfiles,
+     and its reads are independent */
+  if (i == READ_MODE_OBJECT_STORE &&
+      (!CTX->object_store || CTX->requested.split == 1 ||
+       CTX->pconfig->file_mode == FILE_MODE_SUBFILING || CTX->coll_mpi_io_flg == 1 ||
+       in_memory(CTX->pconfig)))
+    return 0;
+  CTX->pconfig->read_mode = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* data generator */
+
+static void generator_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", generator_names[i]);
+}
+
+static int generator_apply(void* ctx, unsigned int i)
+{
+  if ((CTX->requested.generators & (1u << i)) == 0)
+    return 0;
+  CTX->pconfig->generator = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* element type and type conversion */
+
+static void datatype_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", datatype_names[i]);
+}
+
+static int datatype_apply(void* ctx, unsigned int i)
+{
+  if ((CTX->requested.datatypes & (1u << i)) == 0)
+    return 0;
+#ifdef VERIFY_DATA
+  /* the reference data are doubles */
+  if (i != DATATYPE_DOUBLE)
+    return 0;
+#endif
+  CTX->pconfig->datatype = i;
+  return 1;
+}
+
+static int type_conversion_apply(void* ctx, unsigned int i)
+{
+  /* run the baseline first, and converted only if requested */
+  if (i == 1 && CTX->requested.type_conversion == 0)
+    return 0;
+  CTX->pconfig->type_conversion = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* tile decomposition and aggregation */
+
+static void aggregation_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%s", aggregation_names[i]);
+}
+
+static int aggregation_apply(void* ctx, unsigned int i)
+{
+  configuration* pconfig = CTX->pconfig;
+
+  if ((CTX->requested.aggregations & (1u << i)) == 0 ||
+      (i != AGGREGATION_NONE && CTX->size == 1))
+    return 0;
+  /* the aggregators write whole bands of a shared (MPI-IO) file, one
+     dataset at a time, and synchronously, because the node's ranks reuse
+     the window */
+  if (i == AGGREGATION_NODE_AGG &&
+      (CTX->band[0] == 0 || pconfig->file_mode != FILE_MODE_SHARED ||
+       pconfig->split == 1 || pconfig->async == 1 || pconfig->multi_dataset == 1))
+    return 0;
+  /* and the tiles of a band must line up */
+  if (i == AGGREGATION_NODE_AGG && pconfig->scaling == SCALING_STRONG &&
+      (pconfig->rows % pconfig->proc_rows != 0 ||
+       pconfig->cols % pconfig->proc_cols != 0))
+    return 0;
+#ifdef VERIFY_DATA
+  /* the reference data is computed per tile */
+  if (i == AGGREGATION_NODE_AGG)
+    return 0;
+#endif
+  /* the ranks' tiles in a band are doubles, as generated */
+  if (i == AGGREGATION_NODE_AGG && pconfig->datatype != DATATYPE_DOUBLE)
+    return 0;
+  pconfig->aggregation = i;
+  return 1;
+}
+
+/* ========================================================================== */
+/* threads per rank */
+
+static void threads_label(void* ctx, unsigned int i, char* buf, size_t len)
+{
+  snprintf(buf, len, "%u", CTX->requested.thread_counts[i]);
+}
+
+static int threads_apply(void* ctx, unsigned int i)
+{
+  configuration* pconfig = CTX->pconfig;
+  const unsigned int n = CTX->requested.thread_counts[i];
+
+  /* the threads issue synchronous, independent transfers of their own,
+     and collective (metadata) operations need all ranks in the same call */
+  if (n > 1 &&
+      (!CTX->threadsafe || CTX->coll_mpi_io_flg == 1 || pconfig->async == 1 ||
+       pconfig->multi_dataset == 1 || pconfig->coll_metadata == 1))
+    return 0;
+  pconfig->threads = n;
+  return 1;
+}
+
+#undef CTX
+
+void register_axes(param_space* ps, sweep* psw)
+{
+  ps_init(ps, psw, psw->pconfig);
+  psw->threadsafe = threads_supported();
+  psw->object_store = object_store_supported() &&
+    psw->requested.object_store_url[0] != '\0';
+
+  { /* the metadata cache configurations modify the defaults */
+    hid_t fapl;
+    assert((fapl = H5Pcreate(H5P_FILE_ACCESS)) >= 0);
+    psw->mdc_default.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    assert(H5Pget_mdc_config(fapl, &psw->mdc_default) >= 0);
+    assert(H5Pclose(fapl) >= 0);
+  }
+
+  ps_add_axis(ps, "rank", 3, rank_label, rank_apply);
+  ps_add_axis(ps, "slowdim", SLOWDIM_COUNT, slowdim_label, slowdim_apply);
+  ps_add_axis(ps, "layout", LAYOUT_COUNT, layout_label, layout_apply);
+  ps_add_axis(ps, "chunk-scale", psw->requested.nchunk_scales,
+              chunk_scale_label, chunk_scale_apply);
+  ps_add_axis(ps, "chunk-cache", psw->requested.nchunk_caches,
+              chunk_cache_label, chunk_cache_apply);
+  ps_add_axis(ps, "compression", psw->requested.ncompressions,
+              compression_label, compression_apply);
+  ps_add_axis(ps, "fill", FILL_COUNT, fill_label, fill_apply);
+  ps_add_axis(ps, "data-generator", GENERATOR_COUNT, generator_label,
+              generator_apply);
+  ps_add_axis(ps, "datatype", DATATYPE_COUNT, datatype_label, datatype_apply);
+  ps_add_axis(ps, "type-conversion", 2, on_off_label, type_conversion_apply);
+  ps_add_axis(ps, "alignment", 2, alignment_label, alignment_apply);
+  ps_add_axis(ps, "meta-block-size", 2, mblk_label, mblk_apply);
+  ps_add_axis(ps, "fspace-strategy", FSPACE_STRATEGY_COUNT,
+              fspace_strategy_label, fspace_strategy_apply);
+  ps_add_axis(ps, "fspace-page-size", psw->requested.npage_sizes,
+              page_size_label, page_size_apply);
+  ps_add_axis(ps, "metadata-cache", psw->requested.nmdc_configs,
+              mdc_label, mdc_apply);
+  ps_add_axis(ps, "fmt", 2, fmt_label, fmt_apply);
+  ps_add_axis(ps, "multi", 2, on_off_label, multi_apply);
+  ps_add_axis(ps, "append", 2, on_off_label, append_apply);
+  ps_add_axis(ps, "selection-cache", 2, on_off_label, selection_cache_apply);
+  ps_add_axis(ps, "precreate", 2, on_off_label, precreate_apply);
+  ps_add_axis(ps, "file-mode", FILE_MODE_COUNT, file_mode_label,
+              file_mode_apply);
+  /* after the file mode, which decides if a page buffer can be used */
+  ps_add_axis(ps, "page-buffer", psw->requested.npage_buffers,
+              page_buffer_label, page_buffer_apply);
+  ps_add_axis(ps, "coll-metadata", 2, on_off_label, coll_metadata_apply);
+  ps_add_axis(ps, "aggregation", AGGREGATION_COUNT, aggregation_label,
+              aggregation_apply);
+  ps_add_axis(ps, "mpi-hints", hint_combinations(&psw->requested),
+              hints_label, hints_apply);
+  ps_add_axis(ps, "io", (psw->size > 1) ? 2 : 1, io_label, io_apply);
+  /* after the I/O mode, the threads' transfers are independent */
+  ps_add_axis(ps, "threads", psw->requested.nthread_counts, threads_label,
+              threads_apply);
+  ps_add_axis(ps, "read-mode", READ_MODE_COUNT, read_mode_label,
+              read_mode_apply);
+}
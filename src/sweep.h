@@ -0,0 +1,45 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "configuration.h"
+#include "param_space.h"
+
+#include "hdf5.h"
+
+/* The state the axes' apply callbacks update */
+
+typedef struct
+{
+  configuration* pconfig;         /* the current case */
+  configuration  requested;       /* the configuration as read */
+  int            size;
+  int            rank;
+  hid_t          fcpl;
+  hid_t          fapl;
+  hid_t          dapl;
+  hid_t          dxpl;
+  unsigned int   coll_mpi_io_flg;
+  H5AC_cache_config_t mdc_default; /* the library's metadata cache defaults */
+  unsigned int   band[2];         /* a node's band of tiles, 0 if there is none */
+  unsigned int   threadsafe;      /* can threads share the library? */
+  unsigned int   object_store;    /* is there a ros3 VFD and an object-store-url? */
+} sweep;
+
+/* Register the test parameters, slowest changing first */
+
+extern void register_axes(param_space* ps, sweep* psw);
+
+#endif
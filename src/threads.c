@@ -0,0 +1,107 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#include "threads.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <assert.h>
+
+unsigned int threads_supported(void)
+{
+#ifdef _OPENMP
+  hbool_t flg = 0;
+  assert(H5is_library_threadsafe(&flg) >= 0);
+  return (unsigned int)flg;
+#else
+  return 0;
+#endif
+}
+
+/* Select a block of rows of the bounding box [start, end] of a selection */
+
+static hid_t select_rows(hid_t space, int rdim, const hsize_t* start,
+                         const hsize_t* end, hsize_t row0, hsize_t rows)
+{
+  hsize_t first[H5S_MAX_RANK], count[H5S_MAX_RANK], block[H5S_MAX_RANK];
+  hssize_t offset[H5S_MAX_RANK] = { 0 };
+  hid_t result;
+  int i, n;
+
+  assert((result = H5Scopy(space)) >= 0);
+  /* the bounds include the offset (of a cached selection) */
+  assert(H5Soffset_simple(result, offset) >= 0);
+  n = H5Sget_simple_extent_ndims(space);
+  for (i = 0; i < n; ++i)
+    {
+      first[i] = start[i];
+      count[i] = 1;
+      block[i] = end[i] - start[i] + 1;
+    }
+  first[rdim] += row0;
+  block[rdim] = rows;
+  assert(H5Sselect_hyperslab(result, H5S_SELECT_SET, first, NULL, count, block)
+         >= 0);
+  return result;
+}
+
+void threaded_transfer(const configuration* pconfig,
+                       unsigned int write_flg, hid_t dset,
+                       hid_t mem_type, hid_t mspace, hid_t fspace, hid_t dxpl,
+                       void* buf, metrics* pm)
+{
+  hsize_t fstart[H5S_MAX_RANK], fend[H5S_MAX_RANK], mstart[2], mend[2];
+  const int rdim = (int)pconfig->rank - 2; /* of the rows in the file space */
+  double busy = 0.0, wall;
+
+  assert(H5Sget_select_bounds(fspace, fstart, fend) >= 0);
+  assert(H5Sget_select_bounds(mspace, mstart, mend) >= 0);
+
+  wall = -MPI_Wtime();
+#ifdef _OPENMP
+#pragma omp parallel num_threads(pconfig->threads) reduction(+:busy)
+#endif
+  {
+#ifdef _OPENMP
+    const hsize_t t = (hsize_t)omp_get_thread_num();
+    const hsize_t n = (hsize_t)omp_get_num_threads();
+#else
+    const hsize_t t = 0, n = 1;
+#endif
+    /* a balanced block of rows per thread */
+    const hsize_t rows = fend[rdim] - fstart[rdim] + 1;
+    const hsize_t nrows = rows/n + ((t < rows%n) ? 1 : 0);
+    const hsize_t row0 = t*(rows/n) + ((t < rows%n) ? t : rows%n);
+
+    if (nrows > 0)
+      {
+        hid_t fs = select_rows(fspace, rdim, fstart, fend, row0, nrows);
+        hid_t ms = select_rows(mspace, 0, mstart, mend, row0, nrows);
+        double c = -MPI_Wtime();
+        if (write_flg)
+          assert(H5Dwrite(dset, mem_type, ms, fs, dxpl, buf) >= 0);
+        else
+          assert(H5Dread(dset, mem_type, ms, fs, dxpl, buf) >= 0);
+        c += MPI_Wtime();
+        busy += c;
+        assert(H5Sclose(ms) >= 0);
+        assert(H5Sclose(fs) >= 0);
+      }
+  }
+  wall += MPI_Wtime();
+
+  pm->thread_io += wall;
+  pm->thread_wait += (busy > wall) ? busy - wall : 0.0;
+}
@@ -0,0 +1,43 @@
+/* hdf5-iotest -- simple I/O performance tester for HDF5
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Copyright (C) 2020, The HDF Group
+
+   hdf5-iotest is released under the New BSD license (see COPYING).
+   Go to the project home page for more info:
+
+   https://github.com/HDFGroup/hdf5-iotest
+
+*/
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#include "configuration.h"
+#include "metrics.h"
+
+#include "hdf5.h"
+
+/*
+ * Multi-threaded transfers. With threads > 1, the rank's tile (or band)
+ * of a (step, array) is split into blocks of rows, and each OpenMP thread
+ * writes (reads) its block with an H5Dwrite (H5Dread) call of its own. A
+ * thread-safe HDF5 library serializes the calls behind its global lock.
+ * The time the threads spend in their calls beyond the wall time of the
+ * transfer estimates the time they wait for the lock.
+ */
+
+/* Is the library thread-safe, and is there OpenMP? */
+
+extern unsigned int threads_supported(void);
+
+/* Transfer the selections of mspace and fspace with pconfig->threads
+   threads */
+
+extern void threaded_transfer(const configuration* pconfig,
+                              unsigned int write_flg, hid_t dset,
+                              hid_t mem_type, hid_t mspace, hid_t fspace, hid_t dxpl,
+                              void* buf, metrics* pm);
+
+#endif
@@ -12,31 +12,335 @@
 */
 
 #include "utils.h"
+#include "dataset.h"
 
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define GiB 1073741824.0
 
 #define HLINE "--------------------------------------------------------------"\
               "-----------------"
 
 char* async[2] = { "false", "true" };
 
+/* amount per second, 0 if nothing was timed */
+static double rate(double amount, double seconds)
+{
+  return (seconds > 0.0) ? amount/seconds : 0.0;
+}
+
+/* CSV (and restart) representation of the chunk shape and cache */
+
+void format_chunk_scale(const double scale[2], char buf[32])
+{
+  snprintf(buf, 32, "%gx%g", scale[0], scale[1]);
+}
+
+void format_chunk_cache(const chunk_cache* pc, char buf[64])
+{
+  if (pc->nslots == H5D_CHUNK_CACHE_NSLOTS_DEFAULT &&
+      pc->nbytes == H5D_CHUNK_CACHE_NBYTES_DEFAULT)
+    snprintf(buf, 64, "default");
+  else
+    snprintf(buf, 64, "%zu:%zu:%g", pc->nslots, pc->nbytes, pc->w0);
+}
+
+/*
+ *
+ * Allocate an I/O buffer aligned to the configured boundary, or to (and
+ * backed by) huge pages if requested. Release it with free().
+ *
+ */
+
+#define HUGE_PAGE_SIZE 2097152
+
+void* alloc_buffer(const configuration* pconfig, size_t size)
+{
+  void* result = NULL;
+  size_t alignment = (size_t) pconfig->buffer_alignment;
+
+  if (pconfig->huge_pages)
+    { /* whole huge pages, so that the advice covers the entire buffer */
+      alignment = HUGE_PAGE_SIZE;
+      size = ((size + HUGE_PAGE_SIZE - 1)/HUGE_PAGE_SIZE)*HUGE_PAGE_SIZE;
+    }
+  assert(posix_memalign(&result, alignment, (size > 0) ? size : alignment) == 0);
+#ifdef MADV_HUGEPAGE
+  if (pconfig->huge_pages) /* merely advice, transparent huge pages may be off */
+    madvise(result, size, MADV_HUGEPAGE);
+#endif
+  return result;
+}
+
+/*
+ *
+ * Write back and drop the cached pages of an HDF5 file, including the
+ * parts of a split file and any subfiles
+ *
+ */
+
+void evict_file_cache(const char* fname)
+{
+  const char* suffixes[3] = { "", "-[mr].h5", ".subfile_*" };
+  char pattern[PATH_MAX + 16];
+  glob_t g;
+  size_t i;
+  unsigned int k;
+  int fd;
+
+  for (k = 0; k < 3; ++k)
+    {
+      snprintf(pattern, sizeof(pattern), "%s%s", fname, suffixes[k]);
+      if (glob(pattern, 0, NULL, &g) != 0)
+        continue;
+      for (i = 0; i < g.gl_pathc; ++i)
+        if ((fd = open(g.gl_pathv[i], O_RDONLY)) >= 0)
+          {
+            fdatasync(fd); /* dirty pages can't be dropped */
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+          }
+      globfree(&g);
+    }
+}
+
+void format_page_buffer(const page_buffer* pb, char buf[64])
+{
+  if (pb->size == 0)
+    snprintf(buf, 64, "off");
+  else
+    snprintf(buf, 64, "%zu:%u:%u", pb->size, pb->min_meta_perc,
+             pb->min_raw_perc);
+}
+
+void format_mdc_config(const mdc_config* pc, char buf[64])
+{
+  if (pc->initial_size == 0)
+    snprintf(buf, 64, "default");
+  else
+    snprintf(buf, 64, "%zu:%zu%s", pc->initial_size, pc->max_size,
+             pc->evictions ? "" : ":no-evict");
+}
+
+/*
+ *
+ * The ratio of logical to stored bytes of all datasets, on rank 0.
+ * Collective, with a file per process the totals of all files.
+ *
+ */
+
+typedef struct
+{
+  double logical;
+  double stored;
+} storage_totals;
+
+#if H5_VERSION_GE(1,12,0)
+static herr_t add_storage(hid_t group, const char* name, const H5L_info2_t* info,
+                          void* op_data)
+#else
+static herr_t add_storage(hid_t group, const char* name, const H5L_info_t* info,
+                          void* op_data)
+#endif
+{
+  storage_totals* pt = (storage_totals*)op_data;
+  hid_t obj, fspace, dtype;
+  (void) info;
+
+  assert((obj = H5Oopen(group, name, H5P_DEFAULT)) >= 0);
+  if (H5Iget_type(obj) == H5I_DATASET)
+    {
+      assert((fspace = H5Dget_space(obj)) >= 0);
+      assert((dtype = H5Dget_type(obj)) >= 0);
+      pt->logical += (double)H5Sget_simple_extent_npoints(fspace)*H5Tget_size(dtype);
+      pt->stored += (double)H5Dget_storage_size(obj);
+      assert(H5Tclose(dtype) >= 0);
+      assert(H5Sclose(fspace) >= 0);
+    }
+  assert(H5Oclose(obj) >= 0);
+  return 0;
+}
+
+/*
+ *
+ * The image of an in-memory file, from the write phase to the read phase
+ *
+ */
+
+static struct
+{
+  void*  buf;
+  size_t size;
+  size_t capacity;
+} image = { NULL, 0, 0 };
+
+unsigned int in_memory(const configuration* pconfig)
+{
+  return pconfig->core_backing_store == 0 &&
+    pconfig->file_mode == FILE_MODE_SHARED &&
+    pconfig->proc_rows*pconfig->proc_cols == 1 &&
+    strncmp(pconfig->single_process, "core", 16) == 0;
+}
+
+void keep_file_image(hid_t file)
+{
+  ssize_t n;
+
+  assert((n = H5Fget_file_image(file, NULL, 0)) > 0);
+  if ((size_t)n > image.capacity)
+    {
+      free(image.buf);
+      assert((image.buf = malloc((size_t)n)) != NULL);
+      image.capacity = (size_t)n;
+    }
+  assert(H5Fget_file_image(file, image.buf, (size_t)n) == n);
+  image.size = (size_t)n;
+}
+
+hid_t file_image_fapl(hid_t fapl)
+{
+  hid_t result;
+
+  assert(image.buf != NULL);
+  assert((result = H5Pcopy(fapl)) >= 0);
+  assert(H5Pset_file_image(result, image.buf, image.size) >= 0);
+  return result;
+}
+
+size_t file_image_size(void)
+{
+  return image.size;
+}
+
+void free_file_image(void)
+{
+  free(image.buf);
+  image.buf = NULL;
+  image.size = image.capacity = 0;
+}
+
+double compression_ratio(const configuration* pconfig, const char* fname,
+                         hid_t fapl)
+{
+  storage_totals t = { 0.0, 0.0 }, sum = { 0.0, 0.0 };
+  hid_t file;
+
+  assert((file = H5Fopen(fname, H5F_ACC_RDONLY, fapl)) >= 0);
+  assert(H5Lvisit(file, H5_INDEX_NAME, H5_ITER_NATIVE, add_storage, &t) >= 0);
+  assert(H5Fclose(file) >= 0);
+
+  if (pconfig->file_mode == FILE_MODE_PER_PROCESS)
+    {
+      MPI_Reduce(&t, &sum, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+      t = sum;
+    }
+  return rate(t.logical, t.stored);
+}
+
+unsigned int ci_converged(const configuration* pconfig,
+                          double samples[NREP_STATS][MAX_REPETITIONS],
+                          unsigned int n)
+{
+  summary sm;
+  unsigned int i;
+
+  if (pconfig->ci_target <= 0.0 || n < 3)
+    return 0;
+  for (i = 0; i < NREP_STATS; ++i)
+    {
+      summarize(samples[i], n, &sm);
+      if (sm.ci95 > pconfig->ci_target*sm.mean)
+        return 0;
+    }
+  return 1;
+}
+
 void create_output_file(const char* fname)
 {
   FILE *fptr = fopen(fname, "w");
   assert(fptr != NULL);
   fprintf(fptr, "steps,arrays,rows,cols,scaling,proc-rows,proc-cols,"
           "slowdim,rank,version,alignment-increment,alignment-threshold,"
-          "meta-block-size,layout,fill,fmt,io, async, wall [s],fsize [B],"
+          "meta-block-size,layout,fill,fmt,io, async,multi,async-buffers,selection-cache,file-mode,"
+          "chunk-scale,chunk-cache,mpi-hints,mpi-hints-effective,read-mode,"
+          "fspace-strategy,fspace-page-size,page-buffer,metadata-cache,coll-metadata,"
+          "data-generator,compression,compression-applied,aggregation,append,threads,precreate,"
+          "datatype,type-conversion,element-size [B],"
+          "case-key,"
+          "wall [s],fsize [B],"
           "write-phase-min [s],write-phase-max [s],"
           "creat-min [s],creat-max [s],"
           "write-min [s],write-max [s],"
           "read-phase-min [s],read-phase-max [s],"
-          "read-min [s],read-max [s]\n");
+          "read-min [s],read-max [s],"
+          "bytes-rank [B],bytes-total [B],imbalance,"
+          "write-bw [GiB/s],write-bw-wall [GiB/s],write-iops [1/s],compression-ratio,"
+          "read-bw [GiB/s],read-bw-wall [GiB/s],read-iops [1/s],"
+          "create-p50 [s],create-p90 [s],create-p99 [s],create-p99.9 [s],create-pmax [s],"
+          "select-p50 [s],select-p90 [s],select-p99 [s],select-p99.9 [s],select-pmax [s],"
+          "write-p50 [s],write-p90 [s],write-p99 [s],write-p99.9 [s],write-pmax [s],"
+          "read-p50 [s],read-p90 [s],read-p99 [s],read-p99.9 [s],read-pmax [s],"
+          "extend-p50 [s],extend-p90 [s],extend-p99 [s],extend-p99.9 [s],extend-pmax [s],"
+          "async-wait-max [s],async-exec-max [s],async-hidden [%%],"
+          "drain-file-max [s],drain-create-max [s],drain-open-max [s],drain-close-max [s],"
+          "flush-max [s],aggregate-max [s],thread-io-max [s],thread-wait-max [s],"
+          "upload-max [s],open-max [s],first-byte-max [s],read-bw-steady [GiB/s],"
+          "time-series-max [s],time-series-bw [GiB/s],"
+          "sub-box-max [s],sub-box-bw [GiB/s],"
+          "random-tiles-max [s],random-tiles-bw [GiB/s],"
+          "broadcast-max [s],broadcast-bw [GiB/s],"
+          "coll-ios,indep-ios,no-coll-cause,mdc-hit-rate,"
+          "pb-meta-hit-rate,pb-raw-hit-rate,case-begin [s],case-end [s],"
+          "repetitions,"
+          "wall-mean [s],wall-stddev [s],wall-median [s],wall-ci95 [s],"
+          "write-phase-max-mean [s],write-phase-max-stddev [s],"
+          "write-phase-max-median [s],write-phase-max-ci95 [s],"
+          "write-max-mean [s],write-max-stddev [s],write-max-median [s],write-max-ci95 [s],"
+          "read-phase-max-mean [s],read-phase-max-stddev [s],"
+          "read-phase-max-median [s],read-phase-max-ci95 [s],"
+          "read-max-mean [s],read-max-stddev [s],read-max-median [s],read-max-ci95 [s]\n");
   fclose(fptr);
 }
 
+/*
+ *
+ * Total apparent size of files given by (a list of) shell patterns
+ *
+ */
+
+static hsize_t du_size(const char* files)
+{
+  char command[ 2*PATH_MAX + 80 ];
+  FILE *fpipe;
+  char digit = 0;
+  char digits[18];
+  int i = 0;
+
+  strcpy(command, "du --apparent-size -cb ");
+  strcat(command, files);
+  strcat(command, " | tail -1 | sed 's/[^0-9]//g'");
+
+  if (0 == (fpipe = (FILE*)popen(command, "r")))
+    {
+      perror("popen() failed.");
+      exit(EXIT_FAILURE);
+    }
+  while (i < 17 && fread(&digit, sizeof(digit), 1, fpipe))
+    {
+      digits[i] = digit;
+      i++;
+    }
+  digits[i] = '\0';
+  pclose(fpipe);
+  return (hsize_t)atoll(digits);
+}
+
 void print_results
 (
  configuration* pconfig,
@@ -47,6 +351,7 @@ void print_results
 {
   hid_t file;
   hsize_t fsize,fsize_units;
+  unsigned int ipattern;
 
   unsigned majnum, minnum, relnum;
   char version[16];
@@ -56,29 +361,24 @@ void print_results
   if( pconfig->split == 1) 
     {
       /* H5Fget_filesize does not work with split FD */
-      char command[ PATH_MAX + 80 ];
-      FILE *fpipe;
-      char digit = 0;
-      char digits[18];
-      strcpy(command, "du --apparent-size -cb ");
-      strcat(command, hdf5_filename);
-      strcat(command, "*.h5 | tail -1 | sed 's/[^0-9]//g'");
-
-      if (0 == (fpipe = (FILE*)popen(command, "r")))
-        {
-          perror("popen() failed.");
-          exit(EXIT_FAILURE);
-        }
-      int i = 0;
-      while (fread(&digit, sizeof(digit), 1, fpipe))
-        {
-          digits[i] = digit;
-          i++;
-        }
-      pclose(fpipe);
-      fsize = atoi(digits);
-
+      char files[ PATH_MAX + 8 ];
+      snprintf(files, sizeof(files), "%s*.h5", hdf5_filename);
+      fsize = du_size(files);
     } 
+  else if (pconfig->file_mode == FILE_MODE_PER_PROCESS)
+    { /* the files of all ranks */
+      char files[ PATH_MAX + 8 ];
+      snprintf(files, sizeof(files), "%s.?????", hdf5_filename);
+      fsize = du_size(files);
+    }
+  else if (pconfig->file_mode == FILE_MODE_SUBFILING)
+    { /* the stub file and the subfiles (plus their configuration file) */
+      char files[ 2*PATH_MAX + 16 ];
+      snprintf(files, sizeof(files), "%s %s.subfile_*", hdf5_filename, hdf5_filename);
+      fsize = du_size(files);
+    }
+  else if (in_memory(pconfig))
+    fsize = (hsize_t)file_image_size();
   else 
     {
       hid_t fapl;
@@ -103,26 +403,158 @@ void print_results
     cnt++;
   }
   printf("File size [%s]:\t\t%.1f\n", UNIT[cnt], (float)fsize_units + (float)rem / 1024.0);
+  printf("Load imbalance (max/avg):\t%.3f\n", pts->imbalance);
+  if (pts->repetitions > 1)
+    printf("Repetitions:\t\t%u (wall: %.3f +/- %.3f s, median %.3f s)\n",
+           pts->repetitions, pts->rep_stats[0].mean, pts->rep_stats[0].ci95,
+           pts->rep_stats[0].median);
+  printf("Write bandwidth [GiB/s]:\t%.3f (wall: %.3f)\n",
+         rate(pts->total_write_bytes/GiB, pts->max_write_time),
+         rate(pts->total_write_bytes/GiB, pts->max_write_phase));
+  printf("Read bandwidth [GiB/s]:\t%.3f (wall: %.3f)\n",
+         rate(pts->total_read_bytes/GiB, pts->max_read_time),
+         rate(pts->total_read_bytes/GiB, pts->max_read_phase));
+  printf("Write/read IOPS [1/s]:\t%.1f / %.1f\n",
+         rate(pts->write_ops, pts->max_write_time),
+         rate(pts->read_ops, pts->max_read_time));
+  if (pconfig->async == 0) /* not collected through the async VOL */
+    printf("Collective/independent transfers:\t%.0f / %.0f (no-coll-cause 0x%x)\n",
+           pts->coll_ios, pts->indep_ios, pts->no_coll_cause);
+  if (pconfig->compression_applied)
+    printf("Compression ratio:\t%.3f\n", pts->compression_ratio);
+  if (pconfig->async == 1)
+    printf("Async wait/exec [s]:\t%.3f / %.3f (%.1f%% hidden)\n",
+           pts->max_async_wait, pts->max_async_exec, pts->async_hidden);
+  if (pconfig->async == 1)
+    printf("Async drain file/create/open/close [s]:\t%.3f / %.3f / %.3f / %.3f\n",
+           pts->max_drain[0], pts->max_drain[1], pts->max_drain[2],
+           pts->max_drain[3]);
+  if (pconfig->async == 0)
+    printf("Flush [s]:\t\t%.3f\n", pts->max_flush);
+  if (pconfig->aggregation == AGGREGATION_NODE_AGG)
+    printf("Aggregation wait [s]:\t%.3f\n", pts->max_aggregate);
+  if (pconfig->threads > 1)
+    printf("Threads I/O/lock wait [s]:\t%.3f / %.3f (%u threads)\n",
+           pts->max_thread_io, pts->max_thread_wait, pconfig->threads);
+  if (pconfig->read_mode == READ_MODE_OBJECT_STORE)
+    printf("Upload/open/first byte [s]:\t%.3f / %.3f / %.3f (then %.3f GiB/s)\n",
+           pts->max_upload, pts->max_read_open, pts->max_first_byte,
+           rate(pts->total_steady_read_bytes/GiB, pts->max_steady_read_time));
+  printf("Write p50/p99/max [s]:\t%.3e / %.3e / %.3e\n",
+         pts->write_pct[0], pts->write_pct[2], pts->write_pct[NPCT-1]);
+  printf("Read p50/p99/max [s]:\t%.3e / %.3e / %.3e\n",
+         pts->read_pct[0], pts->read_pct[2], pts->read_pct[NPCT-1]);
+  for (ipattern = 1; ipattern < READ_PATTERN_COUNT; ++ipattern)
+    if (pts->max_pattern_time[ipattern] > 0.0)
+      printf("Read %s [GiB/s]:\t%.3f (%.3f s)\n", read_pattern_names[ipattern],
+             rate(pts->total_pattern_bytes[ipattern]/GiB, pts->max_pattern_time[ipattern]),
+             pts->max_pattern_time[ipattern]);
+  if (pconfig->append == 1)
+    printf("Extend p50/p99/max [s]:\t%.3e / %.3e / %.3e\n",
+           pts->extend_pct[0], pts->extend_pct[2], pts->extend_pct[NPCT-1]);
 
   { /* write results to the CSV file */
     FILE *fptr = fopen(pconfig->csv_file, "a");
     assert(fptr != NULL);
-    fprintf(fptr, "%d,%d,%ld,%ld,%s,%d,%d,%s,%d,%s,%llu,%llu,%llu,%s,%s,%s,%s,%s,"
+    int i;
+    char cscale[32], ccache[64], pbuf[64], mdc[64];
+    format_chunk_scale(pconfig->chunk_scale, cscale);
+    format_chunk_cache(&pconfig->cache, ccache);
+    if (pconfig->layout != LAYOUT_CHUNKED)  /* they don't apply */
+      {
+        strcpy(cscale, "n/a");
+        strcpy(ccache, "n/a");
+      }
+    format_page_buffer(&pconfig->pbuf, pbuf);
+    format_mdc_config(&pconfig->mdc, mdc);
+    fprintf(fptr, "%d,%d,%ld,%ld,%s,%d,%d,%s,%d,%s,%llu,%llu,%llu,%s,%s,%s,%s,%s,%d,%d,%d,%s,%s,%s,%s,%s,%s,%s,%llu,%s,%s,%d,%s,%s,%u,%s,%u,%u,%u,%s,%u,%zu,%s,"
             "%.4f,%.0f,%.4f,%.4f,%.4f,%.4f,"
-            "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+            "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f",
             pconfig->steps, pconfig->arrays, pconfig->rows, pconfig->cols,
-            pconfig->scaling, pconfig->proc_rows, pconfig->proc_cols,
-            pconfig->slowest_dimension, pconfig->rank, version,
+            scaling_names[pconfig->scaling], pconfig->proc_rows, pconfig->proc_cols,
+            slowdim_names[pconfig->slowest_dimension], pconfig->rank, version,
             (unsigned long long)pconfig->alignment_increment,
             (unsigned long long)pconfig->alignment_threshold,
 	    (unsigned long long)pconfig->meta_block_size,
-            pconfig->layout, pconfig->fill_values, pconfig->libver_bound_low,
-            pconfig->mpi_io, async[pconfig->async], wall_time, (double)fsize,
+            layout_names[pconfig->layout], fill_names[pconfig->fill_values],
+            pconfig->libver_bound_low,
+            pconfig->mpi_io, async[pconfig->async], pconfig->multi_dataset,
+            pconfig->async_buffers, pconfig->selection_cache,
+            file_mode_names[pconfig->file_mode], cscale, ccache,
+            pconfig->hints_requested, pconfig->hints_effective,
+            read_mode_names[pconfig->read_mode],
+            fspace_strategy_names[pconfig->fspace_strategy],
+            (unsigned long long)pconfig->page_size, pbuf, mdc,
+            pconfig->coll_metadata, generator_names[pconfig->generator],
+            pconfig->compression.label, pconfig->compression_applied,
+            aggregation_names[pconfig->aggregation], pconfig->append,
+            pconfig->threads, pconfig->precreate,
+            datatype_names[pconfig->datatype], pconfig->type_conversion,
+            datatype_size(pconfig->datatype), pconfig->case_key, wall_time, (double)fsize,
             pts->min_write_phase, pts->max_write_phase,
             pts->min_create_time, pts->max_create_time,
             pts->min_write_time, pts->max_write_time,
             pts->min_read_phase, pts->max_read_phase,
             pts->min_read_time, pts->max_read_time);
+    fprintf(fptr, ",%.0f,%.0f,%.3f,%.4f,%.4f,%.1f,%.3f,%.4f,%.4f,%.1f",
+            pts->max_rank_bytes, pts->total_write_bytes, pts->imbalance,
+            rate(pts->total_write_bytes/GiB, pts->max_write_time),
+            rate(pts->total_write_bytes/GiB, pts->max_write_phase),
+            rate(pts->write_ops, pts->max_write_time),
+            pts->compression_ratio,
+            rate(pts->total_read_bytes/GiB, pts->max_read_time),
+            rate(pts->total_read_bytes/GiB, pts->max_read_phase),
+            rate(pts->read_ops, pts->max_read_time));
+    for (i = 0; i < NPCT; ++i)
+      fprintf(fptr, ",%.3e", pts->create_pct[i]);
+    for (i = 0; i < NPCT; ++i)
+      fprintf(fptr, ",%.3e", pts->select_pct[i]);
+    for (i = 0; i < NPCT; ++i)
+      fprintf(fptr, ",%.3e", pts->write_pct[i]);
+    for (i = 0; i < NPCT; ++i)
+      fprintf(fptr, ",%.3e", pts->read_pct[i]);
+    for (i = 0; i < NPCT; ++i)
+      fprintf(fptr, ",%.3e", pts->extend_pct[i]);
+    fprintf(fptr, ",%.4f,%.4f,%.1f", pts->max_async_wait,
+            pts->max_async_exec, pts->async_hidden);
+    for (i = 0; i < 4; ++i)
+      fprintf(fptr, ",%.4f", pts->max_drain[i]);
+    fprintf(fptr, ",%.4f,%.4f,%.4f,%.4f", pts->max_flush, pts->max_aggregate,
+            pts->max_thread_io, pts->max_thread_wait);
+    fprintf(fptr, ",%.4f,%.4f,%.4f,%.4f", pts->max_upload, pts->max_read_open,
+            pts->max_first_byte,
+            rate(pts->total_steady_read_bytes/GiB, pts->max_steady_read_time));
+    for (i = 1; i < READ_PATTERN_COUNT; ++i)
+      fprintf(fptr, ",%.4f,%.4f", pts->max_pattern_time[i],
+              rate(pts->total_pattern_bytes[i]/GiB, pts->max_pattern_time[i]));
+    { /* the library counters, n/a where none were collected (through the
+         async VOL, or without a page buffer) */
+      char counters[6][32];
+      for (i = 0; i < 6; ++i)
+        strcpy(counters[i], "n/a");
+      if (pconfig->async == 0)
+        {
+          snprintf(counters[0], 32, "%.0f", pts->coll_ios);
+          snprintf(counters[1], 32, "%.0f", pts->indep_ios);
+          snprintf(counters[2], 32, "0x%x", pts->no_coll_cause);
+          snprintf(counters[3], 32, "%.4f", pts->mdc_hit_rate);
+          if (pconfig->pbuf.size > 0)
+            {
+              snprintf(counters[4], 32, "%.4f", pts->pb_hit_rate[0]);
+              snprintf(counters[5], 32, "%.4f", pts->pb_hit_rate[1]);
+            }
+        }
+      for (i = 0; i < 6; ++i)
+        fprintf(fptr, ",%s", counters[i]);
+    }
+    /* microseconds, the pause between cases is a few milliseconds */
+    fprintf(fptr, ",%.6f,%.6f,%u",
+            pts->case_begin, pts->case_end, pts->repetitions);
+    for (i = 0; i < NREP_STATS; ++i)
+      fprintf(fptr, ",%.4f,%.4f,%.4f,%.4f", pts->rep_stats[i].mean,
+              pts->rep_stats[i].stddev, pts->rep_stats[i].median,
+              pts->rep_stats[i].ci95);
+    fprintf(fptr, "\n");
     fclose(fptr);
   }
 }
@@ -132,8 +564,14 @@ void print_initial_config(const char* ini, configuration* pconfig)
   printf("Config loaded from '%s':\n  steps=%d, arrays=%d, "
          "rows=%ld, columns=%ld, proc-grid=%dx%d, scaling=%s async=%s\n",
          ini, pconfig->steps, pconfig->arrays, pconfig->rows, pconfig->cols,
-         pconfig->proc_rows, pconfig->proc_cols, pconfig->scaling, async[pconfig->async] 
+         pconfig->proc_rows, pconfig->proc_cols, scaling_names[pconfig->scaling],
+         async[pconfig->async]
          );
+  if (pconfig->async == 1)
+    printf("  async-buffers=%d\n", pconfig->async_buffers);
+  if (pconfig->file_modes & (1u << FILE_MODE_SUBFILING))
+    printf("  subfiling-stripe-size=%llu, subfiling-ioc-per-node=%u\n",
+           pconfig->subfiling_stripe_size, pconfig->subfiling_ioc_per_node);
 }
 
 void print_current_config(configuration* pconfig)
@@ -152,19 +590,73 @@ void print_current_config(configuration* pconfig)
         strncpy(io, "core", 16);
       else if (strncmp(pconfig->single_process, "mpi-io-uni", 16) == 0)
         strncpy(io, "mpi-io-uni", 16);
+      else if (strncmp(pconfig->single_process, "direct", 16) == 0)
+        strncpy(io, "direct", 16);
       else
         strncpy(io, "ufo-io", 16);
     }
 
   printf(HLINE "\n");
-  printf("%s rk=%d %s fill=%s align-[incr:thold]=[%llu:%llu] mblk=%llu fmt=%s io=%s\n",
-         pconfig->slowest_dimension, pconfig->rank,
-         strncmp(pconfig->layout, "contiguous", 16) == 0 ? "cont" : "chkd",
-         pconfig->fill_values,
+  printf("%s rk=%d %s fill=%s align-[incr:thold]=[%llu:%llu] mblk=%llu fmt=%s io=%s%s%s%s%s%s%s%s\n",
+         slowdim_names[pconfig->slowest_dimension], pconfig->rank,
+         pconfig->layout == LAYOUT_CONTIGUOUS ? "cont" : "chkd",
+         fill_names[pconfig->fill_values],
          (unsigned long long)pconfig->alignment_increment,
          (unsigned long long)pconfig->alignment_threshold,
 	 (unsigned long long)pconfig->meta_block_size,
-         pconfig->libver_bound_low, io);
+         pconfig->libver_bound_low, io,
+         pconfig->multi_dataset ? " multi" : "",
+         pconfig->append ? " append" : "",
+         pconfig->precreate ? " precreate" : "",
+         pconfig->selection_cache ? " selcache" : "",
+         (pconfig->file_mode != FILE_MODE_SHARED) ? " " : "",
+         (pconfig->file_mode != FILE_MODE_SHARED) ?
+         file_mode_names[pconfig->file_mode] : "",
+         pconfig->read_mode == READ_MODE_COLD ? " cold-read" :
+         pconfig->read_mode == READ_MODE_OBJECT_STORE ? " object-store" : "");
+  if (pconfig->layout == LAYOUT_CHUNKED &&
+      (pconfig->nchunk_scales > 1 || pconfig->nchunk_caches > 1))
+    {
+      char cscale[32], ccache[64];
+      format_chunk_scale(pconfig->chunk_scale, cscale);
+      format_chunk_cache(&pconfig->cache, ccache);
+      printf("  chunk-scale=%s chunk-cache=%s\n", cscale, ccache);
+    }
+  if (pconfig->fspace_strategies != 1 || pconfig->npage_buffers > 1)
+    {
+      char pbuf[64];
+      format_page_buffer(&pconfig->pbuf, pbuf);
+      printf("  fspace=%s page-size=%llu page-buffer=%s\n",
+             fspace_strategy_names[pconfig->fspace_strategy],
+             (unsigned long long)pconfig->page_size, pbuf);
+    }
+  if (pconfig->compression.id != H5Z_FILTER_NONE)
+    printf("  compression=%s%s\n", pconfig->compression.label,
+           pconfig->compression_applied ? "" :
+           (pconfig->layout != LAYOUT_CHUNKED) ? " (not applied, contiguous)" :
+           ((pconfig->compression.id == H5Z_FILTER_ZFP &&
+             pconfig->datatype > DATATYPE_FLOAT) ||
+            (pconfig->compression.id == H5Z_FILTER_SZIP &&
+             pconfig->datatype == DATATYPE_COMPOUND)) ?
+           " (not applied, element type)" : " (not applied, needs collective I/O)");
+  if (pconfig->aggregations != 1)
+    printf("  aggregation=%s\n", aggregation_names[pconfig->aggregation]);
+  if (pconfig->generators & (pconfig->generators - 1))
+    printf("  data-generator=%s\n", generator_names[pconfig->generator]);
+  if ((pconfig->datatypes & (pconfig->datatypes - 1)) || pconfig->datatype != 0 ||
+      pconfig->type_conversion)
+    printf("  datatype=%s element-size=%zu%s\n", datatype_names[pconfig->datatype],
+           datatype_size(pconfig->datatype),
+           pconfig->type_conversion ? " type-conversion" : "");
+  if (pconfig->nthread_counts > 1 || pconfig->threads > 1)
+    printf("  threads-per-rank=%u\n", pconfig->threads);
+  if (pconfig->nmdc_configs > 1 || pconfig->coll_metadata_modes != 2)
+    {
+      char mdc[64];
+      format_mdc_config(&pconfig->mdc, mdc);
+      printf("  metadata-cache=%s coll-metadata=%d\n", mdc,
+             pconfig->coll_metadata);
+    }
 }
 
 void get_timings
@@ -174,9 +666,12 @@ void get_timings
  double   write_time,
  double   read_phase,
  double   read_time,
+ metrics* pm,
  timings* pts
  )
 {
+  histogram h;
+
   pts->max_write_phase = pts->min_write_phase = 0.0;
   pts->max_create_time = pts->min_create_time = 0.0;
   pts->max_write_time = pts->min_write_time = 0.0;
@@ -203,6 +698,115 @@ void get_timings
              MPI_MIN, 0, MPI_COMM_WORLD);
   MPI_Reduce(&read_time, &pts->max_read_time, 1, MPI_DOUBLE,
              MPI_MAX, 0, MPI_COMM_WORLD);
+
+  pts->max_rank_bytes = pts->total_write_bytes = pts->total_read_bytes = 0.0;
+  MPI_Reduce(&pm->write_bytes, &pts->max_rank_bytes, 1, MPI_DOUBLE,
+             MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&pm->write_bytes, &pts->total_write_bytes, 1, MPI_DOUBLE,
+             MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&pm->read_bytes, &pts->total_read_bytes, 1, MPI_DOUBLE,
+             MPI_SUM, 0, MPI_COMM_WORLD);
+  { /* uneven tiles (or aggregation) leave some ranks with more to write */
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    pts->imbalance = rate(pts->max_rank_bytes, pts->total_write_bytes/size);
+  }
+
+  { /* the I/O time not spent waiting was hidden behind the compute phase */
+    double io[2], sum_io[2] = { 0.0, 0.0 };
+    io[0] = pm->async_wait;
+    io[1] = pm->async_exec;
+    pts->max_async_wait = pts->max_async_exec = pts->async_hidden = 0.0;
+    MPI_Reduce(&pm->async_wait, &pts->max_async_wait, 1, MPI_DOUBLE,
+               MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&pm->async_exec, &pts->max_async_exec, 1, MPI_DOUBLE,
+               MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(io, sum_io, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (sum_io[1] > 0.0 && sum_io[1] > sum_io[0])
+      pts->async_hidden = 100.0*(sum_io[1] - sum_io[0])/sum_io[1];
+  }
+
+  { /* metadata event sets */
+    double drain[4];
+    drain[0] = pm->drain_file;
+    drain[1] = pm->drain_create;
+    drain[2] = pm->drain_open;
+    drain[3] = pm->drain_close;
+    memset(pts->max_drain, 0, sizeof(pts->max_drain));
+    MPI_Reduce(drain, pts->max_drain, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  }
+
+  pts->max_flush = 0.0;
+  MPI_Reduce(&pm->flush, &pts->max_flush, 1, MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+
+  pts->max_aggregate = 0.0;
+  MPI_Reduce(&pm->aggregate, &pts->max_aggregate, 1, MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+
+  { /* multi-threaded transfers */
+    double thread[2];
+    thread[0] = pm->thread_io;
+    thread[1] = pm->thread_wait;
+    pts->max_thread_io = pts->max_thread_wait = 0.0;
+    MPI_Reduce(&thread[0], &pts->max_thread_io, 1, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(&thread[1], &pts->max_thread_wait, 1, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+  }
+
+  { /* the first read vs. the reads after it */
+    double first[3], steady[2], max_steady = 0.0, sum_steady = 0.0;
+    double max_first[3] = { 0.0, 0.0, 0.0 };
+    first[0] = pm->upload;
+    first[1] = pm->read_open;
+    first[2] = pm->read_open + pm->first_read;
+    steady[0] = read_time - pm->first_read;
+    steady[1] = pm->read_bytes - pm->first_read_bytes;
+    MPI_Reduce(first, max_first, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&steady[0], &max_steady, 1, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(&steady[1], &sum_steady, 1, MPI_DOUBLE, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    pts->max_upload = max_first[0];
+    pts->max_read_open = max_first[1];
+    pts->max_first_byte = max_first[2];
+    pts->max_steady_read_time = max_steady;
+    pts->total_steady_read_bytes = sum_steady;
+  }
+
+  pts->coll_ios = pts->indep_ios = 0.0;
+  MPI_Reduce(&pm->coll_ios, &pts->coll_ios, 1, MPI_DOUBLE, MPI_SUM, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(&pm->indep_ios, &pts->indep_ios, 1, MPI_DOUBLE, MPI_SUM, 0,
+             MPI_COMM_WORLD);
+  pts->no_coll_cause = 0;
+  MPI_Reduce(&pm->no_coll_cause, &pts->no_coll_cause, 1, MPI_UNSIGNED,
+             MPI_BOR, 0, MPI_COMM_WORLD);
+  /* rank 0 always writes (a file) */
+  pts->mdc_hit_rate = pm->mdc_hit_rate;
+  pts->pb_hit_rate[0] = rate(pm->pb_hits[0], pm->pb_accesses[0]);
+  pts->pb_hit_rate[1] = rate(pm->pb_hits[1], pm->pb_accesses[1]);
+
+  memset(pts->max_pattern_time, 0, sizeof(pts->max_pattern_time));
+  MPI_Reduce(pm->pattern_time, pts->max_pattern_time, READ_PATTERN_COUNT,
+             MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  memset(pts->total_pattern_bytes, 0, sizeof(pts->total_pattern_bytes));
+  MPI_Reduce(pm->pattern_bytes, pts->total_pattern_bytes, READ_PATTERN_COUNT,
+             MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  hist_merge(&pm->create, &h);
+  hist_percentiles(&h, pts->create_pct);
+  hist_merge(&pm->select, &h);
+  hist_percentiles(&h, pts->select_pct);
+  hist_merge(&pm->write, &h);
+  hist_percentiles(&h, pts->write_pct);
+  pts->write_ops = (double)h.count;
+  hist_merge(&pm->read, &h);
+  hist_percentiles(&h, pts->read_pct);
+  pts->read_ops = (double)h.count;
+  hist_merge(&pm->extend, &h);
+  hist_percentiles(&h, pts->extend_pct);
 }
 
 herr_t set_libver_bounds(configuration* pconfig, int rank, hid_t fapl)
@@ -283,90 +887,140 @@ herr_t set_libver_bounds(configuration* pconfig, int rank, hid_t fapl)
 
 /*
  *
- * Restart from last fully completed configuration
+ * Create a copy of the file access property list with the file driver
+ * of the current file mode
+ *
+ */
+
+hid_t create_file_mode_fapl(configuration* pconfig, hid_t fapl)
+{
+  hid_t result;
+  assert((result = H5Pcopy(fapl)) >= 0);
+
+  if (pconfig->file_mode == FILE_MODE_PER_PROCESS) /* every rank has its own file */
+    assert(H5Pset_fapl_sec2(result) >= 0);
+#ifdef H5_HAVE_SUBFILING_VFD
+  else if (pconfig->file_mode == FILE_MODE_SUBFILING)
+    {
+      H5FD_subfiling_config_t cfg;
+      char ioc[16];
+
+      /* the I/O concentrator count is taken from the environment */
+      if (pconfig->subfiling_ioc_per_node > 0)
+        {
+          snprintf(ioc, 16, "%u", pconfig->subfiling_ioc_per_node);
+          assert(setenv(H5FD_SUBFILING_IOC_PER_NODE, ioc, 1) == 0);
+        }
+      /* the defaults, since the fapl doesn't use the subfiling VFD yet */
+      assert(H5Pget_fapl_subfiling(result, &cfg) >= 0);
+      if (pconfig->subfiling_stripe_size > 0)
+        cfg.shared_cfg.stripe_size = (int64_t)pconfig->subfiling_stripe_size;
+      assert(H5Pset_fapl_subfiling(result, &cfg) >= 0);
+      assert(H5Pclose(cfg.ioc_fapl_id) >= 0);
+    }
+#endif
+
+  return result;
+}
+
+/*
+ *
+ * Record the effective values of the requested MPI-IO hints
  *
  */
 
-void restart(
-             restart_t *ckpt, 
-             const char* fname,
-             char* slow_dim[],
-             char* fill[],
-             char* layout[],
-             char* fmt_low[],
-             char* mpi_mod[],
-             hsize_t mblk_size[],
-             hsize_t align_incr[]
-)
+void get_effective_hints(configuration* pconfig, hid_t file, hid_t fapl)
 {
-  FILE *fptr;                         /* File pointer */
-  static const long max_len = 200+ 1; /* define the max length of the line to read */
-  char buf[max_len + 1];              /* define the buffer and allocate the length */
+  MPI_File *fh = NULL;
+  MPI_Info info;
+  char value[MPI_MAX_INFO_VAL+1], *c;
+  int flag;
+  unsigned int i;
+  size_t len = 0;
+
+  strcpy(pconfig->hints_effective, "none");
+  if (pconfig->nhints == 0 || H5Pget_driver(fapl) != H5FD_MPIO)
+    return;
+
+  assert(H5Fget_vfd_handle(file, fapl, (void**)&fh) >= 0);
+  MPI_File_get_info(*fh, &info);
+  pconfig->hints_effective[0] = '\0';
+  for (i = 0; i < pconfig->nhints; ++i)
+    {
+      MPI_Info_get(info, pconfig->hints[i].key, MPI_MAX_INFO_VAL, value, &flag);
+      if (!flag)
+        strcpy(value, "unset");
+      for (c = value; *c != '\0'; ++c) /* keep the CSV intact */
+        if (*c == ',')
+          *c = ':';
+      len += snprintf(pconfig->hints_effective + len,
+                      sizeof(pconfig->hints_effective) - len, "%s%s=%s",
+                      (i > 0) ? ";" : "", pconfig->hints[i].key, value);
+      if (len >= sizeof(pconfig->hints_effective))
+        len = sizeof(pconfig->hints_effective) - 1;
+    }
+  MPI_Info_free(&info);
+}
+
+/*
+ *
+ * Restart from last fully completed configuration, which is identified
+ * by the case-key column of the last line of the CSV file
+ *
+ */
+
+void restart(const char* fname, char key[CASE_KEY_LEN])
+{
+  FILE *fptr;                          /* File pointer */
+  static const long max_len = 8192+ 1; /* define the max length of the line to read */
+  char buf[max_len + 1];               /* define the buffer and allocate the length */
+  char header[max_len + 1];
+  char delim[] = ",";
+  char *ptr;
+  long fend;
+  size_t nread;
+  int icnt, ikey = -1;
 
   if ((fptr = fopen(fname, "rb")) != NULL)
     {
-      fseek(fptr, -max_len, SEEK_END); /* set pointer to the end of file minus a length. There can be more than one new line character */
-      fread(buf, max_len-1, 1, fptr);  /* read the contents of the file from the fseek() position */
+      /* find the case-key column in the header */
+      if (fgets(header, max_len, fptr) != NULL)
+        {
+          header[strcspn(header, "\n")] = '\0';
+          for (ptr = strtok(header, delim), icnt = 0; ptr != NULL;
+               ptr = strtok(NULL, delim), ++icnt)
+            if (strcmp(ptr, "case-key") == 0)
+              ikey = icnt;
+        }
+
+      fseek(fptr, 0, SEEK_END);
+      fend = ftell(fptr);
+      /* set pointer to the end of file minus a length (or the beginning of a short file),
+         the trailing new line character is not read */
+      fseek(fptr, (fend > max_len) ? fend - max_len : 0, SEEK_SET);
+      nread = fread(buf, 1, (fend > max_len) ? max_len-1 : (fend > 0 ? fend-1 : 0), fptr);
       fclose(fptr);                    /* close the file */
       
-      buf[max_len-1] = '\0';           /* reset the string */
+      buf[nread] = '\0';               /* reset the string */
       char *last_newline = strrchr(buf, '\n'); /* find last occurrence of newline */
-      char *last_line = last_newline+1;        /* jump to it */
+      char *last_line = (last_newline != NULL) ? last_newline+1 : buf; /* jump to it */
       
       printf("RESTARTING FROM LAST LINE: [%s]\n", last_line);
 
-      if( strstr(last_line, slow_dim[1]) != NULL) {
-        ckpt->islow = 1;
-      } else {
-        ckpt->islow = 0;
-      } 
-      if( strstr(last_line, layout[1]) != NULL) {
-        ckpt->ilay = 1;
-      } else {
-        ckpt->ilay = 0;
-      } 
-      if( strstr(last_line, fill[1]) != NULL) {
-        ckpt->ifill = 1;
-      } else {
-        ckpt->ifill = 0;
-      } 
-      if( strstr(last_line, fmt_low[1]) != NULL) {
-        ckpt->ifmt = 1;
-      } else {
-        ckpt->ifmt = 0;
-      } 
-      if( strstr(last_line, mpi_mod[1]) != NULL) {
-        ckpt->imod = 1;
-      } else {
-        ckpt->imod = 0;
-      }
-
-      char delim[] = ",";
-      char *ptr = strtok(last_line,delim);
-      
-      int icnt = 0;
-      while(ptr != NULL)
+      if (ikey < 0 || last_newline == NULL)
         {
-          if(icnt == 8) {
-            ckpt->irank = atoi(ptr);
-          } else if(icnt == 10) {
-            if( (hsize_t)atoi(ptr) != align_incr[0]) {
-              ckpt->ialig = 1;
-            } else {
-              ckpt->ialig = 0;
-            }
-          } else if(icnt == 12) {
-            if( (hsize_t)atoi(ptr) == mblk_size[0] ) {
-              ckpt->imblk = 0;
-            } else {
-              ckpt->imblk = 1;
-            }
-          } else if(icnt == 17) {
-            ckpt->async = (unsigned int)atoi(ptr);
-          }
-          icnt++;
-          ptr = strtok(NULL, delim);
+          printf("ERROR: %s has no case-key column or results\n", fname);
+          MPI_Abort(MPI_COMM_WORLD, 1);
         }
+
+      key[0] = '\0';
+      for (ptr = strtok(last_line, delim), icnt = 0; ptr != NULL;
+           ptr = strtok(NULL, delim), ++icnt)
+        if (icnt == ikey)
+          {
+            strncpy(key, ptr, CASE_KEY_LEN-1);
+            key[CASE_KEY_LEN-1] = '\0';
+          }
     }
   else {
     /* Could not open restart file */
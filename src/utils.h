@@ -15,9 +15,13 @@
 #define UTILS_H
 
 #include "configuration.h"
+#include "metrics.h"
 
 #include "hdf5.h"
 
+/* the timings summarized over repetitions */
+#define NREP_STATS 5
+
 typedef struct
 {
   double min_write_phase;
@@ -30,20 +34,67 @@ typedef struct
   double max_read_phase;
   double min_read_time;
   double max_read_time;
+  /* data volume and operation counts */
+  double max_rank_bytes;
+  double total_write_bytes;
+  /* max/avg bytes per rank */
+  double imbalance;
+  double total_read_bytes;
+  double write_ops;
+  double read_ops;
+  /* async write pipeline */
+  double max_async_wait;
+  double max_async_exec;
+  double async_hidden;
+  /* time to drain the async file, create, open, and close event sets */
+  double max_drain[4];
+  /* metadata (and raw data) flush at the end of the write phase */
+  double max_flush;
+  /* waiting for the ranks of a node (node-agg) */
+  double max_aggregate;
+  /* multi-threaded transfers: the threads' wall time, and their
+     estimated wait for the library lock */
+  double max_thread_io;
+  double max_thread_wait;
+  /* the read phase's upload, file open, and first-byte latency (open and
+     first read), and the reads after the first */
+  double max_upload;
+  double max_read_open;
+  double max_first_byte;
+  double max_steady_read_time;
+  double total_steady_read_bytes;
+  /* what the library did (rank 0's file for the caches) */
+  double coll_ios;
+  double indep_ios;
+  unsigned int no_coll_cause;
+  double mdc_hit_rate;
+  double pb_hit_rate[2];
+  /* wall clock time stamps of the case (seconds since the epoch) */
+  double case_begin;
+  double case_end;
+  /* repetitions of the case: wall time, and the max. write phase, write
+     time, read phase, and read time */
+  unsigned int repetitions;
+  summary rep_stats[NREP_STATS];
+  /* the read patterns other than same-as-write */
+  double max_pattern_time[READ_PATTERN_COUNT];
+  double total_pattern_bytes[READ_PATTERN_COUNT];
+  /* logical over stored dataset bytes */
+  double compression_ratio;
+  /* latency percentiles of individual operations across all ranks */
+  double create_pct[NPCT];
+  double select_pct[NPCT];
+  double write_pct[NPCT];
+  double read_pct[NPCT];
+  double extend_pct[NPCT];
 } timings;
 
-typedef struct
-{
-  unsigned int irank;
-  unsigned int islow;
-  unsigned int ifill;
-  unsigned int ilay;
-  unsigned int ialig;
-  unsigned int imblk;
-  unsigned int ifmt;
-  unsigned int imod;
-  unsigned int async;
-} restart_t;
+/* Is another repetition worth it? Not with at least three repetitions
+   whose 95% CIs are all within ci-target of the means. */
+
+unsigned int ci_converged(const configuration* pconfig,
+                          double samples[NREP_STATS][MAX_REPETITIONS],
+                          unsigned int n);
 
 void create_output_file(const char* fname);
 
@@ -58,6 +109,7 @@ void get_timings
  double   write_time,
  double   read_phase,
  double   read_time,
+ metrics* pm,
  timings* pts
  );
 
@@ -71,17 +123,42 @@ void print_results
 
 herr_t set_libver_bounds(configuration* config, int rank, hid_t fapl);
 
-void restart(
-             restart_t *ckpt, 
-             const char* fname,
-             char* slow_dim[],
-             char* fill[],
-             char* layout[],
-             char* fmt_low[],
-             char* mpi_mod[],
-             hsize_t mblk_size[],
-             hsize_t align_incr[]
-);
+hid_t create_file_mode_fapl(configuration* config, hid_t fapl);
+
+void get_effective_hints(configuration* config, hid_t file, hid_t fapl);
+
+void restart(const char* fname, char key[CASE_KEY_LEN]);
+
+void format_chunk_scale(const double scale[2], char buf[32]);
+
+void format_chunk_cache(const chunk_cache* pc, char buf[64]);
+
+void format_page_buffer(const page_buffer* pb, char buf[64]);
+
+void format_mdc_config(const mdc_config* pc, char buf[64]);
+
+void* alloc_buffer(const configuration* pconfig, size_t size);
+
+void evict_file_cache(const char* fname);
+
+/* Is the file in memory only (the core driver without a backing store)?
+   Then the write phase keeps the file's image for the read phase (and the
+   file size), and nothing touches storage. */
+
+unsigned int in_memory(const configuration* pconfig);
+
+void keep_file_image(hid_t file);
+
+/* A copy of fapl that opens the kept image */
+
+hid_t file_image_fapl(hid_t fapl);
+
+size_t file_image_size(void);
+
+void free_file_image(void);
+
+double compression_ratio(const configuration* pconfig, const char* fname,
+                         hid_t fapl);
 
 
 int parse_time(char *str_in, duration *time);
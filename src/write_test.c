@@ -14,6 +14,10 @@
 #include "write_test.h"
 
 #include "dataset.h"
+#include "instrument.h"
+#include "metrics.h"
+#include "threads.h"
+#include "utils.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -53,39 +57,262 @@ async_sleep(hid_t file_id, hid_t fapl, duration sleep_time)
     sleep_(sleep_time);
 }
 
+/*
+ *
+ * Timed wrappers for the dataset creation and write calls of the hot loop
+ *
+ */
+
+static hid_t timed_create_dataset(hid_t file, const char* path, hid_t lcpl,
+                                  hid_t dapl, const creation_props* pcp,
+                                  time_step* es, double* create_time,
+                                  metrics* pm)
+{
+  hid_t result;
+  double t = -MPI_Wtime();
+  assert((result = create_dataset(file, path, lcpl, dapl, pcp, es)) >= 0);
+  t += MPI_Wtime();
+  *create_time += t;
+  hist_add(&pm->create, t);
+  return result;
+}
+
+/* Open a (pre-created) dataset, which counts as create time */
+
+static hid_t timed_open_dataset(hid_t file, const char* path, hid_t dapl,
+                                time_step* es, double* create_time)
+{
+  hid_t result;
+  *create_time -= MPI_Wtime();
+#if H5_VERSION_GE(1,14,0)
+  if(es != NULL)
+    assert((result = H5Dopen_async(file, path, dapl, es->es_meta_open)) >= 0);
+  else
+#endif
+    assert((result = H5Dopen(file, path, dapl)) >= 0);
+  *create_time += MPI_Wtime();
+  return result;
+}
+
+/* Create (and close) all datasets of a case ahead of the write loop */
+
+static void precreate_datasets(const configuration* pconfig, hid_t file,
+                               hid_t lcpl, hid_t dapl,
+                               const creation_props* pcp, time_step* es,
+                               double* create_time, metrics* pm)
+{
+  const unsigned int step_first_flg =
+    (pconfig->slowest_dimension == SLOWDIM_STEP);
+  /* a dataset per step, per array, or per (step, array) */
+  const unsigned int nsteps =
+    (pconfig->rank == 3 && !step_first_flg) ? 1 : pconfig->steps;
+  const unsigned int narrays =
+    (pconfig->rank == 3 && step_first_flg) ? 1 : pconfig->arrays;
+  unsigned int istep, iarray;
+  char path[255];
+  hid_t dset;
+
+  for (istep = 0; istep < nsteps; ++istep)
+    for (iarray = 0; iarray < narrays; ++iarray)
+      {
+        dataset_path(pconfig, istep, iarray, path);
+        dset = timed_create_dataset(file, path, lcpl, dapl, pcp, es,
+                                    create_time, pm);
+#if H5_VERSION_GE(1,14,0)
+        if(es != NULL)
+          assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
+        else
+#endif
+          assert(H5Dclose(dset) >= 0);
+      }
+}
+
+static void timed_write(const configuration* pconfig, const plan* pp,
+                        hid_t dset, hid_t mspace, hid_t fspace, hid_t dxpl,
+                        const double* wbuf, time_step* es,
+                        double* write_time, metrics* pm)
+{
+  double t = -MPI_Wtime();
+#if H5_VERSION_GE(1,14,0)
+  if(es != NULL)
+    assert(H5Dwrite_async(dset, pp->mem_type, mspace, fspace, dxpl, wbuf, es->es_data) >= 0);
+  else
+#endif
+  if (pconfig->threads > 1) /* see threads.h */
+    threaded_transfer(pconfig, 1, dset, pp->mem_type, mspace, fspace, dxpl,
+                      (void*)wbuf, pm);
+  else
+    assert(H5Dwrite(dset, pp->mem_type, mspace, fspace, dxpl, wbuf) >= 0);
+  t += MPI_Wtime();
+  *write_time += t;
+  hist_add(&pm->write, t);
+  pm->write_bytes += (double)H5Sget_select_npoints(mspace)*pp->elem_size;
+  if (es == NULL) /* the transfer properties are set on completion */
+    count_io_mode(dxpl, pm);
+}
+
+#if H5_VERSION_GE(1,14,0)
+/*
+ * Accumulate the execution time reported for completed asynchronous writes
+ * (connectors that don't track it report UINT64_MAX)
+ */
+static int async_complete(H5ES_op_info_t* op_info, H5ES_status_t status,
+                          hid_t err_stack, void* ctx)
+{
+  metrics* pm = (metrics*) ctx;
+  (void) status;
+  (void) err_stack;
+  if (op_info->op_exec_time != UINT64_MAX)
+    pm->async_exec += (double)op_info->op_exec_time*1.0e-9;
+  return 0;
+}
+
+/* Block until the writes issued from a pipeline slot have completed */
+static void wait_slot(time_step* slot, metrics* pm)
+{
+  pm->async_wait += drain_event_set(slot->es_data);
+}
+#endif
+
+/*
+ * Select the write buffer (and event sets) of the pipeline slot for a step
+ */
+static double* use_slot(configuration* pconfig, unsigned int istep,
+                        unsigned int nslots, double** wring, time_step* ring,
+                        time_step** es, double** mbuf, size_t tile)
+{
+  unsigned int slot = istep % nslots;
+  unsigned int iarray;
+
+  if (ring != NULL)
+    *es = &ring[slot];
+  if (pconfig->multi_dataset)
+    for (iarray = 0; iarray < pconfig->arrays; ++iarray)
+      mbuf[iarray] = wring[slot] + iarray*tile;
+  return wring[slot];
+}
+
+#ifndef VERIFY_DATA
+/*
+ * Generate the tile of a (step, array), and return the buffer to write.
+ * With async I/O, the writes of
+ * earlier arrays from a shared buffer may still be in flight, so the
+ * buffer is only refilled with its slot (once per step), unless each
+ * array has a tile of its own.
+ */
+static double* fill_tile(const configuration* pconfig, const generator* pg,
+                         aggregator* pa, double* buf, const time_step* es,
+                         unsigned int istep, unsigned int iarray,
+                         double* write_time, metrics* pm)
+{
+  /* an aggregator writes its node's band instead */
+  if (pa != NULL)
+    return aggregate_tile(pa, pg, istep, iarray, write_time, pm);
+  if (es != NULL && !pconfig->multi_dataset && iarray > 0)
+    return buf;
+  generate_tile(pg, buf, istep, iarray, pm);
+  return buf;
+}
+#endif
+
+#if H5_VERSION_GE(1,14,0)
+/*
+ * Write the deferred tiles of all arrays of a step with a single
+ * multi-dataset call, and release their file spaces and datasets
+ */
+static void timed_write_multi(const plan* pp, size_t count, hid_t* dsets,
+                              hid_t mspace, hid_t* fspaces, const selection_cache* sc,
+                              hid_t dxpl, double** bufs,
+                              time_step* es, double* write_time, metrics* pm)
+{
+  hid_t *mem_types = (hid_t*) malloc(count*sizeof(hid_t));
+  hid_t *mspaces = (hid_t*) malloc(count*sizeof(hid_t));
+  size_t i;
+  double t;
+
+  for (i = 0; i < count; ++i)
+    {
+      mem_types[i] = pp->mem_type;
+      mspaces[i] = mspace;
+    }
+
+  t = -MPI_Wtime();
+  if(es != NULL)
+    assert(H5Dwrite_multi_async(count, dsets, mem_types, mspaces, fspaces, dxpl,
+                                (const void**)bufs, es->es_data) >= 0);
+  else
+    assert(H5Dwrite_multi(count, dsets, mem_types, mspaces, fspaces, dxpl,
+                          (const void**)bufs) >= 0);
+  t += MPI_Wtime();
+  *write_time += t;
+  hist_add(&pm->write, t);
+  pm->write_bytes += (double)count*H5Sget_select_npoints(mspace)*pp->elem_size;
+  if (es == NULL)
+    count_io_mode(dxpl, pm);
+
+  for (i = 0; i < count; ++i)
+    {
+      release_tile(sc, fspaces[i]);
+      if(es != NULL)
+        assert(H5Dclose_async(dsets[i], es->es_meta_close) >= 0);
+      else
+        assert(H5Dclose(dsets[i]) >= 0);
+    }
+
+  free(mspaces);
+  free(mem_types);
+}
+#endif
+
 void write_test
 (
  configuration* pconfig,
  char * hdf5_filename,
  int size,
  int rank,
- int my_proc_row,
- int my_proc_col,
- unsigned long my_rows,
- unsigned long my_cols,
+ const plan* pp,
  hid_t fcpl,
  hid_t fapl,
  hid_t lcpl,
  hid_t dapl,
  hid_t dxpl,
  unsigned int coll_mpi_io_flg,
+ const generator* pg,
+ aggregator* pa,
+ step_log* plog,
  double* create_time,
- double* write_time
+ double* write_time,
+ metrics* pm
  )
 {
+  const unsigned long my_rows = pp->tile.rows, my_cols = pp->tile.cols;
+  /* are the datasets there already? */
+  const unsigned int exist_flg = (pconfig->precreate || pconfig->reuse);
   unsigned int step_first_flg;
-  unsigned int istep, iarray;
-  double *wbuf;
+  unsigned int istep, iarray, islot, nslots;
+  double *wbuf, **wring;
   hid_t mspace;
-  size_t i;
+  size_t tile, wsize;
 
   char path[255];
 
   hid_t file, dset, fspace;
 
-  time_step *es = NULL;
-  size_t    num_in_progress;
-  hbool_t   op_failed;
+  /* deferred datasets, file spaces, and buffers for multi-dataset writes */
+  hid_t *mdset = NULL, *mfspace = NULL;
+  double **mbuf = NULL;
+
+  /* pipeline of in-flight time steps: one buffer and event set per slot */
+  time_step *es = NULL, *ring = NULL;
+#if H5_VERSION_GE(1,14,0)
+  hid_t     es_file;
+#endif
+
+  /* file space selection templates */
+  selection_cache sc;
+
+  /* the datasets' creation properties */
+  creation_props cp;
 
 #ifdef VERIFY_DATA
   /* Extent of the logical 4D array and partition origin/offset */
@@ -100,9 +327,27 @@ void write_test
    */
 #endif
 
-  step_first_flg = (strncmp(pconfig->slowest_dimension, "step", 16) == 0);
+  step_first_flg = pp->step_first_flg;
+
+  tile = pp->tile_words; /* room for a tile of any element type */
+  wsize = tile;
+  /* distinct tiles per array when they are written together */
+  if (pconfig->multi_dataset)
+    wsize = pconfig->arrays*tile;
+
+  /* with async, up to async-buffers time steps can be in flight */
+  nslots = (pconfig->async == 1) ? pconfig->async_buffers : 1;
+  wring = (double**) malloc(nslots*sizeof(double*));
+  for (islot = 0; islot < nslots; ++islot)
+    wring[islot] = (double*) alloc_buffer(pconfig, wsize*sizeof(double));
+  wbuf = wring[0];
 
-  wbuf = (double*) malloc(my_rows*my_cols*sizeof(double));
+  if (pconfig->multi_dataset)
+    {
+      mdset = (hid_t*) malloc(pconfig->arrays*sizeof(hid_t));
+      mfspace = (hid_t*) malloc(pconfig->arrays*sizeof(hid_t));
+      mbuf = (double**) malloc(pconfig->arrays*sizeof(double*));
+    }
   { /* create the in-memory dataspace */
     hsize_t dims[2];
     dims[0] = (hsize_t)my_rows;
@@ -112,79 +357,79 @@ void write_test
   }
 
 #ifdef VERIFY_DATA
-  unsigned int strong_scaling_flg;
-  strong_scaling_flg = (strncmp(pconfig->scaling, "strong", 16) == 0);
-
-  d[2] = strong_scaling_flg ? pconfig->rows : pconfig->rows * pconfig->proc_rows;
-  d[3] = strong_scaling_flg ? pconfig->cols : pconfig->cols * pconfig->proc_cols;
-
-  o[2] = strong_scaling_flg ? rank * my_rows : my_proc_row * pconfig->rows;
-  o[3] = strong_scaling_flg ? rank * my_cols : my_proc_col * pconfig->cols;
+  d[2] = pp->total_rows;
+  d[3] = pp->total_cols;
+  /* the tile's origin */
+  o[2] = pp->tile.row0;
+  o[3] = pp->tile.col0;
   if (rank == 0)
-    printf("\n\033[1;31m WARNING: Data verification enabled. Timings will be distorted!!!\033[0m\n");
-#else
+    printf("\n\033[1;31m WARNING: Data verification enabled. Generating and verifying data is\n"
+           " excluded from the timings, but the caches will be colder!\033[0m\n");
+#endif
 
-  /* add varability to data when compression is enabled */
-  if (strncmp(pconfig->compress_type, "", 16) != 1) {
-    float deltax, deltay;
-    float x, y;
-    size_t ii;
-    size_t j;
-    float x0 = 0.5f;
-    float y0 = 0.5f;
-
-    deltax = 1.f/( pconfig->rows-1);
-    deltay = 1.f/( pconfig->cols-1);
-
-    y = deltay;
-    for(j = 0, ii = 0; j < (size_t)my_cols; j++) {
-      x = deltax;
-      for(i = 0; i < (size_t)my_rows; i++, ii++) {
-        wbuf[ii] = (x-x0)*(x-x0) + (y-y0)*(y-y0);
-        x += deltax;
-      }
-      y += deltay;
-    }
-  } else {
-    for (i = 0; i < (size_t)my_rows*my_cols; ++i)
-      wbuf[i] = (double) (my_proc_row + my_proc_col);
+#if H5_VERSION_GE(1,14,0)
+  /* the event sets must exist before the file is created asynchronously */
+  if (pconfig->async == 1) {
+    ring = create_event_sets(nslots);
+    for (islot = 0; islot < nslots; ++islot)
+      H5ESregister_complete_func(ring[islot].es_data, async_complete, pm);
+    es = &ring[0];
+    assert((es_file = H5EScreate()) >= 0);
   }
 #endif
 
+  mark_begin(pconfig, "create");
   *create_time -= MPI_Wtime();
+  if (pconfig->reuse) /* the file of the previous run */
+    {
 #if H5_VERSION_GE(1,14,0)
-  if(es != NULL)
-    assert((file = H5Fcreate_async(hdf5_filename, H5F_ACC_TRUNC, fcpl, fapl, 0)) >= 0);
+      if(ring != NULL)
+        assert((file = H5Fopen_async(hdf5_filename, H5F_ACC_RDWR, fapl, es_file)) >= 0);
+      else
+#endif
+        assert((file = H5Fopen(hdf5_filename, H5F_ACC_RDWR, fapl)) >= 0);
+    }
   else
+    {
+#if H5_VERSION_GE(1,14,0)
+      if(ring != NULL)
+        assert((file = H5Fcreate_async(hdf5_filename, H5F_ACC_TRUNC, fcpl, fapl, es_file)) >= 0);
+      else
 #endif
-    assert((file = H5Fcreate(hdf5_filename, H5F_ACC_TRUNC, fcpl, fapl)) >= 0);
+        assert((file = H5Fcreate(hdf5_filename, H5F_ACC_TRUNC, fcpl, fapl)) >= 0);
+    }
 
   *create_time += MPI_Wtime();
 
-  //  int timestep_cnt = pconfig->steps;
-  //for (int ts_index = 0; ts_index < timestep_cnt; ts_index++) {
-  //  time_step *ts = &(time_steps[ts_index]);
-  
-#if H5_VERSION_GE(1,14,0)
-  if (pconfig->async == 1) {
-    es    = calloc(1, sizeof(time_step));
-    es->es_data      = H5EScreate();
-    es->es_meta_data = H5EScreate();
-  }
-#endif
+  /* with selection caching, the selection is built only once per case,
+     and so are the creation properties */
+  *create_time -= MPI_Wtime();
+  create_selection_cache(pconfig, &pp->tile, &sc);
+  create_creation_props(pconfig, pp, coll_mpi_io_flg, &cp);
+  *create_time += MPI_Wtime();
+
+  /* separate the metadata of dataset creation from the write loop */
+  if (pconfig->precreate && !pconfig->reuse)
+    precreate_datasets(pconfig, file, lcpl, dapl, &cp, es, create_time, pm);
+  mark_end(pconfig, "create");
+  mark_begin(pconfig, "write");
 
   switch (pconfig->rank)
     {
     case 4:
       {
         /* a single 4D array */
-        *create_time -= MPI_Wtime();
-        assert((dset = create_dataset(pconfig, file, "dataset", lcpl, dapl, coll_mpi_io_flg, es))
-               >= 0);
-        *create_time += MPI_Wtime();
+        if (exist_flg)
+          dset = timed_open_dataset(file, "dataset", dapl, es, create_time);
+        else
+          dset = timed_create_dataset(file, "dataset", lcpl, dapl, &cp, es,
+                                      create_time, pm);
 
         for (istep = 0; istep < pconfig->steps; ++istep)
           {
+            wbuf = use_slot(pconfig, istep, nslots, wring, ring, &es, mbuf, tile);
+            if (pconfig->append)
+              extend_dataset(pconfig, dset, istep, es, pm);
             for (iarray = 0; iarray < pconfig->arrays; ++iarray)
               {
 #ifdef VERIFY_DATA
@@ -192,26 +437,20 @@ void write_test
                 d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
                 o[0] = step_first_flg ? istep : iarray;
                 o[1] = step_first_flg ? iarray : istep;
-                init_write_buffer(wbuf, &my_rows, &my_cols, d, o);
-#endif
-                assert((fspace = H5Dget_space(dset)) >= 0);
-                *create_time -= MPI_Wtime();
-                create_selection(pconfig, fspace, my_proc_row, my_proc_col,
-                                 istep, iarray);
-                *create_time += MPI_Wtime();
-
-                *write_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                if(es != NULL)
-                  assert(H5Dwrite_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf, es->es_data) >= 0);
-                else
+                init_write_buffer(wbuf, &my_rows, &my_cols, d, o, pm);
+#else
+                wbuf = fill_tile(pconfig, pg, pa, wbuf, es, istep, iarray,
+                                 write_time, pm);
 #endif
-                  assert(H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf) >= 0);
+                fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                     istep, iarray, create_time, pm);
 
-                *write_time += MPI_Wtime();
-                assert(H5Sclose(fspace) >= 0);
+                timed_write(pconfig, pp, dset, mspace, fspace, dxpl, wbuf, es, write_time, pm);
+                release_tile(&sc, fspace);
               }
             
+            log_step(plog, istep, *write_time);
+
             /* Simulate the compute phase */
             if (pconfig->delay.enable == 1) {
               if (istep != pconfig->steps - 1) { // no sleep after the last es
@@ -222,15 +461,16 @@ void write_test
             }
             /* Even though we are writing the same data at each time step, normally we would need to 
              * fill the write buffer again before outputting the next time step. Here we
-             * make sure write has completed before "filling" the write buffer again */
+             * make sure the writes from the buffer used by the next step have completed
+             * before "filling" it again (with a single buffer, that's the current step) */
 #if H5_VERSION_GE(1,14,0)
-            if(es != NULL)
-              H5ESwait(es->es_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
+            if(ring != NULL) /* block only if the next step reuses an in-flight slot */
+              wait_slot(&ring[(istep + 1) % nslots], pm);
 #endif
           }
 #if H5_VERSION_GE(1,14,0)
         if(es != NULL)
-          assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+          assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
         else
 #endif
           assert(H5Dclose(dset) >= 0); 
@@ -242,43 +482,39 @@ void write_test
           {
             for (istep = 0; istep < pconfig->steps; ++istep)
               {
-                *create_time -= MPI_Wtime();
-                sprintf(path, "step=%d", istep);
-                assert((dset = create_dataset(pconfig, file, path, lcpl, dapl, coll_mpi_io_flg, es))
-                       >= 0);
-                *create_time += MPI_Wtime();
+                wbuf = use_slot(pconfig, istep, nslots, wring, ring, &es, mbuf, tile);
+                dataset_path(pconfig, istep, 0, path);
+                if (exist_flg)
+                  dset = timed_open_dataset(file, path, dapl, es, create_time);
+                else
+                  dset = timed_create_dataset(file, path, lcpl, dapl, &cp, es,
+                                              create_time, pm);
 
                 for (iarray = 0; iarray < pconfig->arrays; ++iarray)
                   {
 #ifdef VERIFY_DATA
                     d[0] = pconfig->steps; d[1] = pconfig->arrays;
                     o[0] = istep; o[1] = iarray;
-                    init_write_buffer(wbuf, &my_rows, &my_cols, d, o);
-#endif
-                    assert((fspace = H5Dget_space(dset)) >= 0);
-                    *create_time -= MPI_Wtime();
-                    create_selection(pconfig, fspace, my_proc_row,
-                                     my_proc_col, istep, iarray);
-                    *create_time += MPI_Wtime();
-
-                    *write_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                    if(es != NULL)
-                      assert(H5Dwrite_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf, es->es_data) >= 0);
-                    else
+                    init_write_buffer(wbuf, &my_rows, &my_cols, d, o, pm);
+#else
+                    wbuf = fill_tile(pconfig, pg, pa, wbuf, es, istep, iarray,
+                                     write_time, pm);
 #endif
-                      assert(H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf) >= 0);
+                    fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                         istep, iarray, create_time, pm);
 
-                    *write_time += MPI_Wtime();
-                    assert(H5Sclose(fspace) >= 0);
+                    timed_write(pconfig, pp, dset, mspace, fspace, dxpl, wbuf, es, write_time, pm);
+                    release_tile(&sc, fspace);
                   }
 #if H5_VERSION_GE(1,14,0)
                 if(es != NULL)
-                  assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                  assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                 else
 #endif
                   assert(H5Dclose(dset) >= 0);
 
+                log_step(plog, istep, *write_time);
+
                 if (pconfig->delay.enable == 1) {
                   if (istep != pconfig->steps - 1) { // no sleep after the last es
                     if (rank == 0)
@@ -289,10 +525,11 @@ void write_test
                   
                 /* Even though we are writing the same data at each time step, normally we would need to 
                  * fill the write buffer again before outputting the next time step. Here we
-                 * make sure write has completed before "filling" the write buffer again */
+                 * make sure the writes from the buffer used by the next step have completed
+                 * before "filling" it again (with a single buffer, that's the current step) */
 #if H5_VERSION_GE(1,14,0)
-                if(es != NULL)
-                  H5ESwait(es->es_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
+                if(ring != NULL) /* block only if the next step reuses an in-flight slot */
+                  wait_slot(&ring[(istep + 1) % nslots], pm);
 #endif
               }
           }
@@ -300,45 +537,53 @@ void write_test
           {
             for (istep = 0; istep < pconfig->steps; ++istep)
               {
+                wbuf = use_slot(pconfig, istep, nslots, wring, ring, &es, mbuf, tile);
                 for (iarray = 0; iarray < pconfig->arrays; ++iarray)
                   {
-                    sprintf(path, "array=%d", iarray);
-                    *create_time -= MPI_Wtime();
-                    if (istep > 0)
-                      assert((dset = H5Dopen(file, path, dapl)) >= 0);
+                    dataset_path(pconfig, 0, iarray, path);
+                    if (istep > 0 || exist_flg)
+                      dset = timed_open_dataset(file, path, dapl, es, create_time);
                     else
-                      assert((dset = create_dataset(pconfig, file, path,
-                                                    lcpl, dapl, coll_mpi_io_flg, es)) >= 0);
-                    *create_time += MPI_Wtime();
+                      dset = timed_create_dataset(file, path, lcpl, dapl, &cp,
+                                                  es, create_time, pm);
+                    if (pconfig->append)
+                      extend_dataset(pconfig, dset, istep, es, pm);
 
 #ifdef VERIFY_DATA
                     d[0] = pconfig->arrays; d[1] = pconfig->steps;
                     o[0] = iarray; o[1] = istep;
-                    init_write_buffer(wbuf, &my_rows, &my_cols, d, o);
-#endif
-                    assert((fspace = H5Dget_space(dset)) >= 0);
-                    *create_time -= MPI_Wtime();
-                    create_selection(pconfig, fspace, my_proc_row,
-                                     my_proc_col, istep, iarray);
-                    *create_time += MPI_Wtime();
-
-                    *write_time -= MPI_Wtime();
-#if H5_VERSION_GE(1,14,0)
-                    if(es != NULL)
-                      assert(H5Dwrite_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf, es->es_data) >= 0);
-                    else
+                    init_write_buffer(pconfig->multi_dataset ? mbuf[iarray] : wbuf,
+                                      &my_rows, &my_cols, d, o, pm);
+#else
+                    wbuf = fill_tile(pconfig, pg, pa, pconfig->multi_dataset ? mbuf[iarray] : wbuf,
+                                     es, istep, iarray, write_time, pm);
 #endif
-                      assert(H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf) >= 0);
-
-                    *write_time += MPI_Wtime();
-                    assert(H5Sclose(fspace) >= 0);
+                    fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                         istep, iarray, create_time, pm);
+
+                    if (pconfig->multi_dataset)
+                      { /* defer the write to a single call per step */
+                        mdset[iarray] = dset;
+                        mfspace[iarray] = fspace;
+                        continue;
+                      }
+
+                    timed_write(pconfig, pp, dset, mspace, fspace, dxpl, wbuf, es, write_time, pm);
+                    release_tile(&sc, fspace);
 #if H5_VERSION_GE(1,14,0)
                     if(es != NULL)
-                      assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                      assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                     else
 #endif
                       assert(H5Dclose(dset) >= 0); 
                   }
+#if H5_VERSION_GE(1,14,0)
+                if (pconfig->multi_dataset)
+                  timed_write_multi(pp, pconfig->arrays, mdset, mspace, mfspace, &sc, dxpl,
+                                    mbuf, es, write_time, pm);
+#endif
+
+                log_step(plog, istep, *write_time);
 
                 if (pconfig->delay.enable == 1) {
                   if (istep != pconfig->steps - 1) { // no sleep after the last es
@@ -349,10 +594,11 @@ void write_test
                 }
                 /* Even though we are writing the same data at each time step, normally we would need to 
                  * fill the write buffer again before outputting the next time step. Here we
-                 * make sure write has completed before "filling" the write buffer again */
+                 * make sure the writes from the buffer used by the next step have completed
+                 * before "filling" it again (with a single buffer, that's the current step) */
 #if H5_VERSION_GE(1,14,0)
-                if(es != NULL)
-                  H5ESwait(es->es_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
+                if(ring != NULL) /* block only if the next step reuses an in-flight slot */
+                  wait_slot(&ring[(istep + 1) % nslots], pm);
 #endif
               }
           }
@@ -362,51 +608,55 @@ void write_test
       {
         for (istep = 0; istep < pconfig->steps; ++istep)
           {
+            wbuf = use_slot(pconfig, istep, nslots, wring, ring, &es, mbuf, tile);
             for (iarray = 0; iarray < pconfig->arrays; ++iarray)
               {
-                *create_time -= MPI_Wtime();
                 /* group per step or array of 2D datasets */
-                sprintf(path, (step_first_flg ?
-                               "step=%d/array=%d" : "array=%d/step=%d"),
-                        (step_first_flg ? istep : iarray),
-                        (step_first_flg ? iarray : istep));
-                assert((dset = create_dataset(pconfig, file, path,
-                                              lcpl, dapl, coll_mpi_io_flg, es)) >= 0);
-                *create_time += MPI_Wtime();
+                dataset_path(pconfig, istep, iarray, path);
+                if (exist_flg)
+                  dset = timed_open_dataset(file, path, dapl, es, create_time);
+                else
+                  dset = timed_create_dataset(file, path, lcpl, dapl, &cp, es,
+                                              create_time, pm);
 
 #ifdef VERIFY_DATA
                 d[0] = step_first_flg ? pconfig->steps : pconfig->arrays;
                 d[1] = step_first_flg ? pconfig->arrays : pconfig->steps;
                 o[0] = step_first_flg ? istep : iarray;
                 o[1] = step_first_flg ? iarray : istep;
-                init_write_buffer(wbuf, &my_rows, &my_cols, d, o);
+                init_write_buffer(pconfig->multi_dataset ? mbuf[iarray] : wbuf,
+                                  &my_rows, &my_cols, d, o, pm);
+#else
+                wbuf = fill_tile(pconfig, pg, pa, pconfig->multi_dataset ? mbuf[iarray] : wbuf,
+                                 es, istep, iarray, write_time, pm);
 #endif
 
-                assert((fspace = H5Dget_space(dset)) >= 0);
-                *create_time -= MPI_Wtime();
-                create_selection(pconfig, fspace, my_proc_row, my_proc_col,
-                                 istep, iarray);
-                *create_time += MPI_Wtime();
-
-                *write_time -= MPI_Wtime();
+                fspace = select_tile(pconfig, &sc, dset, &pp->tile,
+                                     istep, iarray, create_time, pm);
 
-#if H5_VERSION_GE(1,14,0)
-                if(es != NULL) {
-                  assert(H5Dwrite_async(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf, es->es_data) >= 0);
-                }
-                else
-#endif
-                  assert(H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, dxpl, wbuf) >= 0);
+                if (pconfig->multi_dataset)
+                  { /* defer the write to a single call per step */
+                    mdset[iarray] = dset;
+                    mfspace[iarray] = fspace;
+                    continue;
+                  }
 
-                *write_time += MPI_Wtime();
-                assert(H5Sclose(fspace) >= 0);
+                timed_write(pconfig, pp, dset, mspace, fspace, dxpl, wbuf, es, write_time, pm);
+                release_tile(&sc, fspace);
 #if H5_VERSION_GE(1,14,0)
                 if(es != NULL)
-                  assert(H5Dclose_async(dset, es->es_meta_data) >= 0);
+                  assert(H5Dclose_async(dset, es->es_meta_close) >= 0);
                 else
 #endif
                   assert(H5Dclose(dset) >= 0);
               }
+#if H5_VERSION_GE(1,14,0)
+            if (pconfig->multi_dataset)
+              timed_write_multi(pp, pconfig->arrays, mdset, mspace, mfspace, &sc, dxpl,
+                                mbuf, es, write_time, pm);
+#endif
+
+            log_step(plog, istep, *write_time);
 
             if (pconfig->delay.enable == 1) {
               if (istep != pconfig->steps - 1) { // no sleep after the last ts
@@ -417,10 +667,11 @@ void write_test
             }
             /* Even though we are writing the same data at each time step, normally we would need to 
              * fill the write buffer again before outputting the next time step. Here we
-             * make sure write has completed before "filling" the write buffer again */
+             * make sure the writes from the buffer used by the next step have completed
+             * before "filling" it again (with a single buffer, that's the current step) */
 #if H5_VERSION_GE(1,14,0)
-            if(es != NULL)
-              H5ESwait(es->es_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed); 
+            if(ring != NULL) /* block only if the next step reuses an in-flight slot */
+              wait_slot(&ring[(istep + 1) % nslots], pm);
 #endif
           }
       }
@@ -429,19 +680,58 @@ void write_test
       break;
     }
 
+  mark_end(pconfig, "write");
+
+  /* what MPI-IO made of the requested hints, and what the caches did (not
+     timed, and not through the async VOL) */
+  get_effective_hints(pconfig, file, fapl);
+  if (ring == NULL)
+    file_counters(pconfig, file, pm);
+
+  mark_begin(pconfig, "close");
+
+  /* with async, the flush would only queue up behind the writes */
+  if (pconfig->async == 0)
+    { /* separate the cost of flushing metadata (and raw data) from the close */
+      pm->flush -= MPI_Wtime();
+      assert(H5Fflush(file, H5F_SCOPE_LOCAL) >= 0);
+      pm->flush += MPI_Wtime();
+    }
+
+  if (in_memory(pconfig))
+    { /* for the read phase, copying it is not I/O */
+      pm->kernel -= MPI_Wtime();
+      keep_file_image(file);
+      pm->kernel += MPI_Wtime();
+    }
+
   *create_time -= MPI_Wtime();
 #if H5_VERSION_GE(1,14,0)
-  if(es != NULL) {
-      H5ESwait(es->es_meta_data, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed);
-      H5ESclose(es->es_meta_data);
-      H5ESclose(es->es_data);
-      assert(H5Fclose_async(file, 0) >= 0);
-      free(es);
+  if(ring != NULL) {
+      for (islot = 0; islot < nslots; ++islot) {
+        wait_slot(&ring[islot], pm);
+        drain_metadata_event_sets(&ring[islot], pm);
+      }
+      assert(H5Fclose_async(file, es_file) >= 0);
+      pm->drain_file += drain_event_set(es_file);
+      assert(H5ESclose(es_file) >= 0);
+      close_event_sets(ring, nslots);
   } else
 #endif
     assert(H5Fclose(file) >= 0);
 
   *create_time += MPI_Wtime();
+  mark_end(pconfig, "close");
   assert(H5Sclose(mspace) >= 0);
-  free(wbuf);
+  close_selection_cache(&sc);
+  close_creation_props(&cp);
+  if (pconfig->multi_dataset)
+    {
+      free(mbuf);
+      free(mfspace);
+      free(mdset);
+    }
+  for (islot = 0; islot < nslots; ++islot)
+    free(wring[islot]);
+  free(wring);
 }
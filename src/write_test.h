@@ -14,7 +14,12 @@
 #ifndef WRITE_TEST_H
 #define WRITE_TEST_H
 
+#include "aggregate.h"
 #include "configuration.h"
+#include "dataset.h"
+#include "generators.h"
+#include "metrics.h"
+#include "step_log.h"
 #include "hdf5.h"
 
 extern void write_test
@@ -23,18 +28,19 @@ extern void write_test
  char * hdf5_filename,
  int size,
  int rank,
- int my_proc_row,
- int my_proc_col,
- unsigned long my_rows,
- unsigned long my_cols,
+ const plan* pp,
  hid_t fcpl,
  hid_t fapl,
  hid_t lcpl,
  hid_t dapl,
  hid_t dxpl,
  unsigned int coll_mpi_io_flg,
+ const generator* pg,
+ aggregator* pa,
+ step_log* plog,
  double* create_time,
- double* write_time
+ double* write_time,
+ metrics* pm
  );
 
 #endif